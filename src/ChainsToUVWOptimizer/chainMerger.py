@@ -7,21 +7,8 @@ import sys
 import copy
 from dd.autoref import BDD
 
-# ================
-# Main -- Tool to compute a UVW from chains
-# ================
-if __name__ == '__main__':
-
-    introLine = sys.stdin.readline()
-    introLine = introLine.strip().split(" ")
-    if len(introLine)!=3:
-        sys.stderr.write("Error: Expected header line in the form output by a chain learner tool.\n")
-        sys.exit(1)
-    assert introLine[0]=="LEARNING"
-    nofBits = int(introLine[1])
-    nofLetters = int(introLine[2])
-    
-    # Prepare initial UVW, propositions, and letters
+def prepareUVW(nofBits,nofLetters):
+    """Prepares the initial UVW and its propositions. Returns the UVW and the BDDs for the letters."""
     uvw = UVW()
     for i in range(0,nofBits):
         uvw.propositions.append("v"+str(i))
@@ -36,65 +23,95 @@ if __name__ == '__main__':
             else:
                 thisOne = thisOne & ~ uvw.ddMgr.var("v"+str(j))
         letters.append(thisOne)
+    return (uvw,letters)
+
+
+def addChain(uvw,letters,line):
+    """Adds the chain from a CHAIN line to the UVW"""
+    chainParts = line.split(" ")
+    
+    parts = chainParts[1:]
+    nofStates = (len(parts)+1)//2
+    
+    # Back to the front
+    def parseLabel(thisPart):
+        label = uvw.ddMgr.false
+        for j,k in enumerate(thisPart):
+            if k=="1":
+                label |= letters[j]
+            elif k=="0":
+                pass
+            else:
+                assert False
+        return label
+    
+    lastState = uvw.addStateButNotNewListOfTransitionsForTheNewState("",True)
+    uvw.transitions.append([(lastState,parseLabel(parts[-1]))])
+
+    for j in range(nofStates-2,-1,-1):
+        nextState = uvw.addStateButNotNewListOfTransitionsForTheNewState("",False)         
+        uvw.transitions.append([(lastState,parseLabel(parts[j*2+1])),(nextState,parseLabel(parts[j*2]))])
+        lastState = nextState
+    
+    uvw.initialStates.append(lastState)
+    uvw.removeStatesWithoutOutgoingTransitions()
+
+
+def reduceUVW(uvw):
+    """Runs the cheaper reduction passes over the whole UVW"""
+    if len(uvw.transitions)>1:
+        uvw.simulationBasedMinimization()
+
+    if len(uvw.transitions)>1:
+        uvw.mergeEquivalentlyReachableStates()
+
+    if len(uvw.transitions)>1:
+        uvw.removeStatesWithoutOutgoingTransitions()
+        uvw.removeForwardReachableBackwardSimulatingStates()
+    if len(uvw.transitions)>1:
+        uvw.removeUnreachableStates()
+    if len(uvw.transitions)>1:
+        uvw.makeTransientStatesNonRejecting()
+
+
+def mergeChains(lines,useSimulationCache=True):
+    """Computes a UVW from the lines of a chain list. The simulation cache only serves to speed up the
+       reductions and can be disabled for checking that it does not change the result."""
+    lines = iter(lines)
+    introLine = next(lines,"").strip().split(" ")
+    if len(introLine)!=3:
+        sys.stderr.write("Error: Expected header line in the form output by a chain learner tool.\n")
+        sys.exit(1)
+    assert introLine[0]=="LEARNING"
+    nofBits = int(introLine[1])
+    nofLetters = int(introLine[2])
+    
+    # Prepare initial UVW, propositions, and letters
+    (uvw,letters) = prepareUVW(nofBits,nofLetters)
+    uvw.simulationCache.enabled = useSimulationCache
                 
     # Parse UVW
     ended = False
-    for line in sys.stdin.readlines():
+    for line in lines:
         line = line.strip()
         if line.startswith("CHAIN"):
             assert not ended
-            chainParts = line.split(" ")
-            
-            parts = chainParts[1:]
-            nofStates = (len(parts)+1)//2
-            
-            # Back to the front
-            def parseLabel(thisPart):
-                label = uvw.ddMgr.false
-                for j,k in enumerate(thisPart):
-                    if k=="1":
-                        label |= letters[j]
-                    elif k=="0":
-                        pass
-                    else:
-                        assert False
-                return label
-            
-            lastState = uvw.addStateButNotNewListOfTransitionsForTheNewState("",True)
-            uvw.transitions.append([(lastState,parseLabel(parts[-1]))])
-
-            for j in range(nofStates-2,-1,-1):
-                nextState = uvw.addStateButNotNewListOfTransitionsForTheNewState("",False)         
-                uvw.transitions.append([(lastState,parseLabel(parts[j*2+1])),(nextState,parseLabel(parts[j*2]))])
-                lastState = nextState
-            
-            uvw.initialStates.append(lastState)
-            uvw.removeStatesWithoutOutgoingTransitions()
-    
-            if len(uvw.transitions)>1:
-                uvw.simulationBasedMinimization()
-
-            if len(uvw.transitions)>1:
-                uvw.mergeEquivalentlyReachableStates()
-
-            if len(uvw.transitions)>1:
-                uvw.removeStatesWithoutOutgoingTransitions()
-                uvw.removeForwardReachableBackwardSimulatingStates()
-            if len(uvw.transitions)>1:
-                uvw.removeUnreachableStates()
-            if len(uvw.transitions)>1:
-                uvw.makeTransientStatesNonRejecting()
+            addChain(uvw,letters,line)
+            reduceUVW(uvw)
 
         elif line.startswith("END"):
             ended = True
 
     # Final expensive optimization
     uvw.bruteForceStateRemoval()
- 
 
-    # ==========================            
-    # Print as graphviz
-    # ==========================
+    # The cached simulation results are no longer needed
+    uvw.simulationCache.clear()
+    return uvw
+
+
+def toGraphviz(uvw):
+    """Prints the UVW in graphviz format"""
     resultLines = ["digraph {"]
 
     # Assign state names
@@ -134,6 +151,13 @@ if __name__ == '__main__':
     resultLines.append(" \""+neverClaimStateNames[0]+"\" -> \""+neverClaimStateNames[0]+"\" [label=\"true\"];")
 
     resultLines.append("}")
-    
-    print("\n".join(resultLines))
+    return "\n".join(resultLines)
+
+
+# ================
+# Main -- Tool to compute a UVW from chains
+# ================
+if __name__ == '__main__':
 
+    uvw = mergeChains(sys.stdin)
+    print(toGraphviz(uvw))
@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+#
+# Regression and timing check for the chain merger. Computes the UVW for every given chain
+# list once with and once without the simulation cache, and prints the running times.
+#
+# Usage: checkChainMerger.py [<chainFile> [<expectedGraphvizFile>]]...
+#
+# Without file arguments, the chain list in the "regression" folder is used. The output with
+# the simulation cache must be the same as the one without it, and as the one in the expected
+# graphviz file (if given). Returns 1 if any of the outputs differ.
+import os
+import sys
+import time
+from chainMerger import mergeChains, toGraphviz
+
+
+def runChainMerger(chainFile,useSimulationCache):
+    with open(chainFile) as inFile:
+        startTime = time.time()
+        uvw = mergeChains(inFile,useSimulationCache)
+        result = toGraphviz(uvw)
+        return (result,time.time()-startTime)
+
+
+# ================
+# Main
+# ================
+if __name__ == '__main__':
+
+    files = sys.argv[1:]
+    if len(files)==0:
+        regressionDir = os.path.join(os.path.dirname(os.path.abspath(__file__)),"regression")
+        files = [os.path.join(regressionDir,"A1_8_3_0_c3_first100.chains")]
+
+    # Pair up chain files and expected outputs
+    tasks = []
+    for fileName in files:
+        if fileName.endswith(".dot"):
+            if len(tasks)==0 or tasks[-1][1] is not None:
+                sys.stderr.write("Error: Expected graphviz file "+fileName+" given without a chain file before it.\n")
+                sys.exit(1)
+            tasks[-1] = (tasks[-1][0],fileName)
+        else:
+            tasks.append((fileName,None))
+
+    returnValue = 0
+    for (chainFile,expectedFile) in tasks:
+        (resultUncached,secondsUncached) = runChainMerger(chainFile,False)
+        (result,seconds) = runChainMerger(chainFile,True)
+
+        if result==resultUncached:
+            status = "same as without the cache"
+        else:
+            status = "DIFFERENT FROM THE OUTPUT WITHOUT THE CACHE"
+            returnValue = 1
+
+        if expectedFile is not None:
+            with open(expectedFile) as inFile:
+                if inFile.read().strip()==result.strip():
+                    status += ", same as expected"
+                else:
+                    status += ", DIFFERENT FROM EXPECTED"
+                    returnValue = 1
+
+        print(os.path.basename(chainFile)+": without cache: %.2f s; with cache: %.2f s, %s" % (secondsUncached,seconds,status))
+
+    sys.exit(returnValue)
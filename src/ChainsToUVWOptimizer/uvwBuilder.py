@@ -25,8 +25,50 @@ from dd.autoref import BDD
 from parser import Node, NodeTypes
 import parser
 
+class SimulationCache:
+    """Caches the simulation relation and the reachability implications between states by the structure
+       of the automaton parts that they depend on. Whether a state A simulates a state B only depends on
+       the states reachable from A and B, and whether reaching a state implies reaching another one only
+       depends on the states from which they can be reached. Both are identified by a signature number
+       (for the same structure, the same number), so that the cached results remain valid while states
+       are added, merged, removed and renumbered. All UVWs sharing a cache must use the same BDD manager.
+
+       Transition labels enter the signatures as small label numbers, which are assigned by the number of
+       the BDD node of a label. The BDD nodes of the labels are kept alive by the cache (so that their numbers
+       are not reused for other BDDs) until the cache is cleared, which happens whenever the cache has more
+       than "maxNofEntries" entries, and at the latest when the cache is no longer needed. A disabled cache
+       is never used, so that all results are recomputed (for checking that the cache does not change them)."""
+    def __init__(self,maxNofEntries = 1000000,enabled = True):
+        self.maxNofEntries = maxNofEntries
+        self.enabled = enabled
+        self.clear()
+
+    def clear(self):
+        self.forwardSignatures = {}
+        self.backwardSignatures = {}
+        self.simulation = {}
+        self.reachabilityImplications = {}
+        self.labelNumbers = {}
+        self.labels = [] # Keeps the BDD nodes of the numbered labels alive
+
+    def getLabelNumber(self,label):
+        node = int(label)
+        number = self.labelNumbers.get(node)
+        if number is None:
+            number = len(self.labels)
+            self.labelNumbers[node] = number
+            self.labels.append(label)
+        return number
+
+    def limitSize(self):
+        """Empties the cache if it has too many entries. As this renumbers the signatures, this must only be
+           called when no signatures computed earlier are still in use."""
+        nofEntries = len(self.forwardSignatures)+len(self.backwardSignatures)+len(self.simulation)+len(self.reachabilityImplications)+len(self.labels)
+        if nofEntries>self.maxNofEntries:
+            self.clear()
+
 class UVW:
-    def __init__(self,ddMgr = None):
+    def __init__(self,ddMgr = None,simulationCache = None):
         """Initializes the UVW. There is always a fail state with no. 0"""
         self.stateNames = ["reject"] # Init with reject stat
         self.rejecting = [True]
@@ -34,6 +76,10 @@ class UVW:
             self.ddMgr = BDD()
         else:
             self.ddMgr = ddMgr
+        if simulationCache is None:
+            self.simulationCache = SimulationCache()
+        else:
+            self.simulationCache = simulationCache
         self.transitions = [[(0,self.ddMgr.true)]]
         self.initialStates = []
         self.propositions = []
@@ -180,7 +226,7 @@ class UVW:
     @staticmethod
     def isBisimulationEquivalent(uvw1Pre,uvw2):
         # Make a copy as we are going to modify it - but the BDD manager must be the same
-        uvw1 = UVW(uvw1Pre.ddMgr)
+        uvw1 = UVW(uvw1Pre.ddMgr,uvw1Pre.simulationCache)
         uvw1.stateNames = copy.copy(uvw1Pre.stateNames)
         uvw1.rejecting = copy.copy(uvw1Pre.rejecting)
         uvw1.transitions = copy.copy(uvw1Pre.transitions)
@@ -271,8 +317,9 @@ class UVW:
         return result
 
     def __del__(self):
-        # First delete the transitions, as only then, all BDD nodes are freed.
+        # First delete the transitions and the cache (if no other UVW uses it), as only then, all BDD nodes are freed.
         del self.transitions
+        self.simulationCache = None
         self.ddMgr = None
 
     def addStateButNotNewListOfTransitionsForTheNewState(self,stateName,rejecting=False):
@@ -371,11 +418,14 @@ class UVW:
     def getBottomUpAndReverseBottomUpOrder(self):
         # 1. Compute a bottom-up ordering of all states
         bottomUpOrder = []
+        inBottomUpOrder = set([])
         while len(bottomUpOrder)!=len(self.stateNames):
             for i in range(0,len(self.stateNames)):
-                allDone = reduce(lambda x,y: x and y, [a in bottomUpOrder or a==i for (a,b) in self.transitions[i]],True)
-                if not i in bottomUpOrder and allDone:
-                    bottomUpOrder.append(i)
+                if not i in inBottomUpOrder:
+                    allDone = reduce(lambda x,y: x and y, [a in inBottomUpOrder or a==i for (a,b) in self.transitions[i]],True)
+                    if allDone:
+                        bottomUpOrder.append(i)
+                        inBottomUpOrder.add(i)
 
         # 1b. Reverse bottom up order
         reverseBottomUpOrder = copy.copy(bottomUpOrder)
@@ -385,8 +435,43 @@ class UVW:
         return (bottomUpOrder,reverseBottomUpOrder)
 
 
+    def getForwardSignatures(self,bottomUpOrder):
+        """Numbers the states such that two states get the same number if and only if the parts of the UVW
+           reachable from them are the same up to renumbering."""
+        self.simulationCache.limitSize()
+        signatureTable = self.simulationCache.forwardSignatures
+        getLabelNumber = self.simulationCache.getLabelNumber
+        signatures = [None for i in bottomUpOrder]
+        for state in bottomUpOrder:
+            key = (self.rejecting[state],frozenset([(-1 if a==state else signatures[a],getLabelNumber(b)) for (a,b) in self.transitions[state]]))
+            if not key in signatureTable:
+                signatureTable[key] = len(signatureTable)
+            signatures[state] = signatureTable[key]
+        return signatures
+
+    def getBackwardSignatures(self,bottomUpOrder,inverseTransitions):
+        """Numbers the states such that two states get the same number if and only if the parts of the UVW
+           from which they can be reached are the same up to renumbering."""
+        self.simulationCache.limitSize()
+        signatureTable = self.simulationCache.backwardSignatures
+        getLabelNumber = self.simulationCache.getLabelNumber
+        signatures = [None for i in bottomUpOrder]
+        for index in range(len(bottomUpOrder)-1,-1,-1):
+            state = bottomUpOrder[index]
+            key = (state in self.initialStates,frozenset([(-1 if a==state else signatures[a],getLabelNumber(b)) for (a,b) in inverseTransitions[state]]))
+            if not key in signatureTable:
+                signatureTable[key] = len(signatureTable)
+            signatures[state] = signatureTable[key]
+        return signatures
+
     def computeSimulationRelation(self,bottomUpOrder,reverseBottomUpOrder):
         # 2. Compute simulation relation
+        if self.simulationCache.enabled:
+            signatures = self.getForwardSignatures(bottomUpOrder)
+            cache = self.simulationCache.simulation
+        else:
+            signatures = range(0,len(bottomUpOrder))
+            cache = {}
         simulationRelation = []
         for orderPosA in range(0,len(bottomUpOrder)):
             simulationForA = []
@@ -395,6 +480,13 @@ class UVW:
             for orderPosB in range(0,len(bottomUpOrder)):
                 stateB = bottomUpOrder[orderPosB]
 
+                # Already known?
+                cacheKey = (signatures[stateA],signatures[stateB])
+                cachedResult = cache.get(cacheKey)
+                if cachedResult is not None:
+                    simulationForA.append(cachedResult)
+                    continue
+
                 # Check whether state A accepts at least as much as state B does
                 # This means that for every action in automaton A, there must be one in B to a state that is at least as restrictive.
                 # Double-Self-loops are fine if we do not have that state A is rejecting but state B is not
@@ -414,6 +506,7 @@ class UVW:
                     simIsFine = simIsFine and (restCond == self.ddMgr.false)
 
                 simulationForA.append(simIsFine)
+                cache[cacheKey] = simIsFine
         return simulationRelation
 
 
@@ -427,12 +520,26 @@ class UVW:
             for (a,b) in self.transitions[i]:
                 inverseTransitions[a].append((i,b))
 
+        if self.simulationCache.enabled:
+            signatures = self.getBackwardSignatures(bottomUpOrder,inverseTransitions)
+            cache = self.simulationCache.reachabilityImplications
+        else:
+            signatures = range(0,len(bottomUpOrder))
+            cache = {}
+
         # Compute reachability implying states
         for aIndex in range(len(bottomUpOrder)-1,-1,-1):
             for bIndex in range(len(bottomUpOrder)-1,-1,-1):
                 aState = bottomUpOrder[aIndex]
                 bState = bottomUpOrder[bIndex]
 
+                # Already known?
+                cacheKey = (signatures[aState],signatures[bState])
+                cachedResult = cache.get(cacheKey)
+                if cachedResult is not None:
+                    reachabilityImplications[aState][bState] = cachedResult
+                    continue
+
                 # Check if for every incoming transition to state "a", there is
                 # a corresponding on the state "b"
                 foundUnimplyingCase = False
@@ -456,27 +563,23 @@ class UVW:
 
                 # Store results
                 reachabilityImplications[aState][bState] = not foundUnimplyingCase
+                cache[cacheKey] = not foundUnimplyingCase
 
         return reachabilityImplications
 
     def computeTransitiveClosureOfTransitionRelation(self):
         result = set([])
 
+        # Search forward from every state
         for a in range(0,len(self.transitions)):
             result.add((a,a))
-        for i,a in enumerate(self.transitions):
-            for (b,c) in a:
-                result.add((i,b))
-
-        lastResult = set([])
-        while len(result)!=len(lastResult):
-            lastResult = result
-            result = set([])
-            for (a,b) in lastResult:
-                result.add((a,b))
-                for (c,d) in lastResult:
-                    if c==b:
-                        result.add((a,d))
+            todo = [a]
+            while len(todo)>0:
+                thisOne = todo.pop()
+                for (b,c) in self.transitions[thisOne]:
+                    if not (a,b) in result:
+                        result.add((a,b))
+                        todo.append(b)
         return result
 
     def mergeEquivalentlyReachableStates(self):
@@ -656,7 +759,7 @@ class UVW:
         # See which ones we can remove    
         for stateNum in range(1,len(self.stateNames)):
             
-            uvw1 = UVW(self.ddMgr)
+            uvw1 = UVW(self.ddMgr,self.simulationCache)
             uvw1.stateNames = copy.copy(self.stateNames)
             uvw1.rejecting = copy.copy(self.rejecting)
             uvw1.transitions = copy.copy(self.transitions)
@@ -0,0 +1,527 @@
+/*
+ * Microbenchmarks for the hot code paths of the chain enumerator.
+ *
+ * Build with quick_build_benchmark.sh and run from this directory:
+ *
+ *   ./benchmark
+ *       Runs the microbenchmarks and prints the results (time per operation, allocations per
+ *       operation, throughput) as JSON to stdout.
+ *
+ *   ./benchmark --e2e [--baseline benchmark_baseline.json] [--write-baseline <file>] [--tolerance 0.25]
+ *       Runs the solver on selected examples from the "examples" folder (in all three modes, and on a
+ *       synthetic problem with finite words) and compares the running times and the chains found
+ *       against a stored baseline. Returns 1 if the chains differ from the baseline, and 2 if some
+ *       example is slower than the baseline by more than the tolerance (and by more than 1 ms, as
+ *       shorter running times are too noisy to be compared).
+ *       The numbers of oracle calls (model checking runs over the examples) are reported for both
+ *       minimization strategies (without and with the "-g" parameter of the solver). Returns 1 as
+ *       well if the two strategies find different chains.
+ *
+ * All synthetic inputs are generated with fixed seeds.
+ */
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+#include <new>
+#include <unistd.h>
+#include "tools.hpp"
+#include "learner.hpp"
+#include "result_buffers.hpp"
+
+
+// Count all allocations by replacing the global allocation functions
+static unsigned long nofAllocations = 0;
+
+void *operator new(size_t size) {
+    nofAllocations++;
+    void *result = malloc(size==0?1:size);
+    if (result==nullptr) throw std::bad_alloc();
+    return result;
+}
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+
+/**
+ * @brief A temporary file that is deleted when the object is destroyed
+ */
+class TemporaryFile {
+    std::string path;
+public:
+    TemporaryFile() {
+        char name[] = "/tmp/uniteBenchmarkXXXXXX";
+        int fd = mkstemp(name);
+        if (fd==-1) throw "Error: Cannot create temporary file.";
+        close(fd);
+        path = name;
+    }
+    ~TemporaryFile() { std::remove(path.c_str()); }
+    std::string &getPath() { return path; }
+};
+
+
+/**
+ * @brief Writes a random learning problem in the input format of the solver
+ * @param safety if true, examples are finite words (no lasso cycle)
+ */
+void writeSyntheticProblem(const std::string &path, unsigned int nofBits, unsigned int nofExamples, unsigned int maxLength, bool safety, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::ofstream out(path);
+    out << "Learning problem with character width: " << nofBits << "\n";
+    out << "Nof characters: " << (1 << nofBits) << "\n";
+    std::uniform_int_distribution<unsigned int> lengthDist(1,maxLength);
+    std::uniform_int_distribution<unsigned int> bitDist(0,1);
+    for (unsigned int i=0;i<nofExamples;i++) {
+        unsigned int handleLength = lengthDist(rng)-1;
+        for (unsigned int j=0;j<handleLength*nofBits;j++) out << bitDist(rng);
+        if (!safety) {
+            out << " ";
+            unsigned int cycleLength = lengthDist(rng);
+            for (unsigned int j=0;j<cycleLength*nofBits;j++) out << bitDist(rng);
+        }
+        out << "\n";
+    }
+    if (out.fail()) throw "Error: Cannot write synthetic learning problem.";
+}
+
+
+/**
+ * @brief Decompresses a gzipped example file into a file
+ */
+void decompressExample(const std::string &gzPath, const std::string &path) {
+    std::string command = "gzip -dc '"+gzPath+"' > '"+path+"'";
+    if (system(command.c_str())!=0) throw std::string("Error: Cannot decompress ")+gzPath;
+}
+
+
+/**
+ * @brief Random points of the search space over 0/1 dimensions
+ */
+std::vector<std::vector<int> > randomPoints(unsigned int nofPoints, unsigned int nofDimensions, double probabilityOfOne, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution dist(probabilityOfOne);
+    std::vector<std::vector<int> > result(nofPoints,std::vector<int>(nofDimensions));
+    for (auto &point : result) {
+        for (auto &value : point) value = dist(rng)?1:0;
+    }
+    return result;
+}
+
+
+/**
+ * @brief Runs benchmarks and collects the results as JSON objects
+ */
+class BenchmarkRunner {
+    std::vector<std::string> results;
+    double minimalSeconds;
+public:
+    unsigned long sink = 0; // Results of the benchmarked functions go here, so that they are not optimized away
+
+    BenchmarkRunner(double _minimalSeconds) : minimalSeconds(_minimalSeconds) {}
+
+    /**
+     * @brief Runs "fn" repeatedly for at least the minimal time
+     * @param itemsPerOp the number of items processed by one call to "fn", for the throughput
+     * @param itemUnit what an item is
+     */
+    template<class Fn> void run(const std::string &name, double itemsPerOp, const std::string &itemUnit, Fn fn) {
+        fn(); // Warm-up
+        unsigned long iterations = 0;
+        unsigned long allocationsBefore = nofAllocations;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        while ((elapsed<minimalSeconds) || (iterations<3)) {
+            fn();
+            iterations++;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+        }
+        unsigned long allocations = nofAllocations-allocationsBefore;
+
+        std::ostringstream json;
+        json << "{\"name\": \"" << name << "\", \"iterations\": " << iterations;
+        json << ", \"ns_per_op\": " << elapsed*1e9/iterations;
+        json << ", \"allocations_per_op\": " << (double)allocations/iterations;
+        json << ", \"throughput\": " << itemsPerOp*iterations/elapsed << ", \"throughput_unit\": \"" << itemUnit << "/s\"}";
+        results.push_back(json.str());
+        std::cerr << json.str() << std::endl;
+    }
+
+    void print(std::ostream &os) const {
+        os << "{\"benchmarks\": [\n";
+        for (size_t i=0;i<results.size();i++) {
+            os << "  " << results[i] << ((i+1<results.size())?",\n":"\n");
+        }
+        os << "]}\n";
+    }
+};
+
+
+void benchmarkParsing(BenchmarkRunner &runner) {
+    for (bool safety : {false,true}) {
+        TemporaryFile file;
+        writeSyntheticProblem(file.getPath(),3,20000,12,safety,1);
+        std::ifstream in(file.getPath(),std::ios::ate);
+        double fileSize = in.tellg();
+        runner.run(std::string("LearningProblem/parse/synthetic_")+(safety?"finite":"lasso")+"_20000",fileSize/1e6,"MB",[&]() {
+            LearningProblem problem(file.getPath(),-1,safety?SAFETY:LIVENESS);
+            runner.sink += problem.getNofLetters();
+        });
+    }
+}
+
+
+void benchmarkModelChecking(BenchmarkRunner &runner, LearningProblem &problem, const std::string &name, unsigned int uvwChainLength) {
+    std::ostream nullStream(nullptr);
+    Learner learner(problem,uvwChainLength,paretoenumerator::DIMENSIONWISE,nullStream);
+    unsigned int nofExamples = 0;
+    for (auto it = problem.begin();it!=problem.end();it++) nofExamples++;
+
+    // Mostly accepting chains, so that most examples need to be looked at
+    std::vector<std::vector<int> > chains = randomPoints(64,problem.getNofLetters()*(2*uvwChainLength-1),0.8,2);
+    if (problem.getSafetyMode()!=LIVENESS) {
+        // Respect the fixed values for the "end of word" character set by Learner::learn.
+        unsigned int nofLetters = problem.getNofLetters();
+        for (auto &chain : chains) {
+            for (unsigned int i=0;i<2*uvwChainLength-1;i++) chain[i*nofLetters+nofLetters-1] = 1;
+            for (unsigned int i=0;i<nofLetters-1;i++) chain[nofLetters*(2*uvwChainLength-2)+i] = (problem.getSafetyMode()==FINITEWORDS)?1:0;
+            chain[chain.size()-1] = 0;
+        }
+    }
+    size_t next = 0;
+    runner.run("modelCheckingFn/"+name+"_c"+std::to_string(uvwChainLength),nofExamples,"examples",[&]() {
+        runner.sink += learner.acceptsAllExamples(chains[next],uvwChainLength);
+        next = (next+1) % chains.size();
+    });
+}
+
+
+void benchmarkModelChecking(BenchmarkRunner &runner, const std::string &examplesDir) {
+    {
+        TemporaryFile file;
+        writeSyntheticProblem(file.getPath(),3,2000,12,false,3);
+        LearningProblem problem(file.getPath(),-1,LIVENESS);
+        benchmarkModelChecking(runner,problem,"synthetic_2000",2);
+        benchmarkModelChecking(runner,problem,"synthetic_2000",3);
+    }
+    {
+        TemporaryFile file;
+        writeSyntheticProblem(file.getPath(),3,2000,12,true,4);
+        LearningProblem problem(file.getPath(),-1,SAFETY);
+        benchmarkModelChecking(runner,problem,"synthetic_safety_2000",3);
+        LearningProblem problemFinite(file.getPath(),-1,FINITEWORDS);
+        benchmarkModelChecking(runner,problemFinite,"synthetic_finite_2000",3);
+    }
+    for (auto const &example : std::vector<std::pair<std::string,unsigned int> >{{"A2_4_3_0",3},{"A1_8_2_0",2}}) {
+        TemporaryFile file;
+        decompressExample(examplesDir+"/"+example.first+".txt.gz",file.getPath());
+        LearningProblem problem(file.getPath(),-1,LIVENESS);
+        benchmarkModelChecking(runner,problem,example.first,example.second);
+    }
+}
+
+
+void benchmarkResultBuffers(BenchmarkRunner &runner) {
+    for (unsigned int size : {100,1000,10000}) {
+        std::vector<std::vector<int> > points = randomPoints(size,40,0.5,5);
+        std::vector<std::vector<int> > queries = randomPoints(256,40,0.5,6);
+        paretoenumerator::PointEncoding encoding(std::vector<std::pair<int,int> >(40,std::pair<int,int>(0,1)));
+        runner.run("NegativeResultBuffer/insert_"+std::to_string(size),size,"points",[&]() {
+            paretoenumerator::NegativeResultBuffer buffer(encoding);
+            for (auto const &point : points) buffer.addPoint(point);
+            runner.sink += buffer.isContained(points[0]);
+        });
+        paretoenumerator::NegativeResultBuffer buffer(encoding);
+        for (auto const &point : points) buffer.addPoint(point);
+        size_t next = 0;
+        runner.run("NegativeResultBuffer/query_"+std::to_string(size),1,"queries",[&]() {
+            runner.sink += buffer.isContained(queries[next]);
+            next = (next+1) % queries.size();
+        });
+    }
+}
+
+
+void benchmarkCleanParetoFront(BenchmarkRunner &runner) {
+    for (unsigned int size : {100,1000}) {
+        std::vector<std::vector<int> > points = randomPoints(size,40,0.5,7);
+        std::list<std::vector<int> > input(points.begin(),points.end());
+        runner.run("cleanParetoFront/"+std::to_string(size),size,"points",[&]() {
+            runner.sink += paretoenumerator::cleanParetoFront(input).size();
+        });
+    }
+}
+
+
+void benchmarkSimulationFilter(BenchmarkRunner &runner) {
+    TemporaryFile file;
+    writeSyntheticProblem(file.getPath(),3,10,4,false,8);
+    LearningProblem problem(file.getPath(),-1,LIVENESS);
+    const unsigned int uvwChainLength = 3;
+    for (unsigned int nofPastChains : {100,1000}) {
+        std::ostream nullStream(nullptr);
+        Learner learner(problem,uvwChainLength,paretoenumerator::DIMENSIONWISE,nullStream);
+        for (auto const &chain : randomPoints(nofPastChains,problem.getNofLetters()*(2*uvwChainLength-1),0.5,9)) {
+            learner.reportChain(chain,uvwChainLength);
+        }
+        std::vector<std::vector<int> > chains = randomPoints(64,problem.getNofLetters()*(2*uvwChainLength-1),0.5,10);
+        size_t next = 0;
+        runner.run("callbackFn/simulationFilter_"+std::to_string(nofPastChains),1,"chains",[&]() {
+            runner.sink += learner.isSimulatedByPastChain(chains[next],uvwChainLength);
+            next = (next+1) % chains.size();
+        });
+    }
+}
+
+
+/**
+ * @brief The result of running the solver on one example file
+ */
+class EndToEndResult {
+public:
+    std::string name;
+    double milliseconds = 0.0;
+    unsigned int nofChains = 0;
+    std::string outputHash;
+    unsigned long nofOracleCalls = 0;
+    unsigned long nofOracleCallsGroupTesting = 0;
+    std::string outputHashGroupTesting;
+    double baselineMilliseconds = -1.0;
+    std::string baselineOutputHash;
+};
+
+
+/**
+ * @brief Reads an end-to-end baseline file as written by this tool. Only the format written by this tool is supported.
+ */
+void readBaseline(const std::string &path, std::vector<EndToEndResult> &results) {
+    std::ifstream in(path);
+    if (in.fail()) throw "Error: Cannot read baseline file.";
+    std::string line;
+    while (std::getline(in,line)) {
+        size_t namePos = line.find("\"name\": \"");
+        if (namePos==std::string::npos) continue;
+        namePos += 9;
+        std::string name = line.substr(namePos,line.find('"',namePos)-namePos);
+        for (auto &result : results) {
+            if (result.name==name) {
+                size_t msPos = line.find("\"ms\": ");
+                size_t hashPos = line.find("\"output_hash\": \"");
+                if ((msPos==std::string::npos) || (hashPos==std::string::npos)) throw "Error: Malformed line in baseline file.";
+                std::istringstream(line.substr(msPos+6)) >> result.baselineMilliseconds;
+                hashPos += 16;
+                result.baselineOutputHash = line.substr(hashPos,line.find('"',hashPos)-hashPos);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief An input for the end-to-end benchmarks. The learning problem is read from a file in the "examples" folder,
+ * or, if "fileName" is empty, it is a synthetic learning problem with finite words. (Random words contain all
+ * letters, so that the synthetic problem only has chains in the finite-word mode.)
+ */
+class EndToEndExample {
+public:
+    std::string fileName;
+    unsigned int uvwChainLength;
+    int nofLines; // As for the "-l" parameter
+    SafetyMode safetyMode;
+    std::string appendedLines; // Added to the end of the learning problem
+
+    std::string getName() const {
+        std::string name = (fileName=="")?"synthetic_finite_1000":fileName.substr(0,fileName.find('.'));
+        if (appendedLines!="") name += "+"+std::to_string(std::count(appendedLines.begin(),appendedLines.end(),'\n'))+"_lines";
+        name += " -c "+std::to_string(uvwChainLength)+" -l "+std::to_string(nofLines);
+        if (safetyMode==SAFETY) name += " -s";
+        if (safetyMode==FINITEWORDS) name += " -f";
+        return name;
+    }
+
+    void writeProblem(const std::string &examplesDir, const std::string &path) const {
+        if (fileName=="") {
+            writeSyntheticProblem(path,2,1000,10,true,11);
+        } else if (fileName.size()>3 && fileName.substr(fileName.size()-3)==".gz") {
+            decompressExample(examplesDir+"/"+fileName,path);
+        } else {
+            std::ifstream in(examplesDir+"/"+fileName);
+            std::ofstream out(path);
+            out << in.rdbuf();
+            if (in.fail() || out.fail()) throw std::string("Error: Cannot copy ")+fileName;
+        }
+        if (appendedLines!="") {
+            std::ofstream out(path,std::ios::app);
+            out << appendedLines;
+            if (out.fail()) throw "Error: Cannot append to learning problem.";
+        }
+    }
+};
+
+
+int runEndToEnd(const std::string &examplesDir, const std::string &baselinePath, const std::string &writeBaselinePath, double tolerance, unsigned int repetitions) {
+
+    // The safety and finite-word cases use the prefix trie instead of the lasso-shaped examples
+    std::vector<EndToEndExample> selection = {
+        {"A0_16_2_3.txt.gz",2,-1,LIVENESS,""},
+        {"A1_8_2_0.txt.gz",2,-1,LIVENESS,""},
+        {"A2_4_3_0.txt.gz",3,-1,LIVENESS,""},
+        {"A3_4_2_1.txt.gz",3,-1,LIVENESS,""},
+        {"A4_8_3_2.txt.gz",3,3000,LIVENESS,""},
+        {"A1_8_3_0.txt.gz",3,5000,LIVENESS,""},
+        {"A1_8_2_0.txt.gz",2,-1,LIVENESS," \n"}, // An example with an empty handle and an empty cycle
+        {"safety_test.txt",3,-1,SAFETY,""},
+        {"safety_test.txt",4,-1,SAFETY,""},
+        {"safety_test.txt",3,-1,FINITEWORDS,""},
+        {"safety_test.txt",4,-1,FINITEWORDS,""},
+        {"",4,-1,FINITEWORDS,""}
+    };
+
+    std::vector<EndToEndResult> results;
+    for (auto const &example : selection) {
+        TemporaryFile file;
+        example.writeProblem(examplesDir,file.getPath());
+        EndToEndResult result;
+        result.name = example.getName();
+        // The FNV-1a hash of the chains found
+        auto hashOutput = [](const std::string &output) {
+            uint64_t hash = 14695981039346656037ULL;
+            for (char c : output) {
+                hash ^= (unsigned char)c;
+                hash *= 1099511628211ULL;
+            }
+            std::ostringstream hashString;
+            hashString << std::hex << hash;
+            return hashString.str();
+        };
+        for (unsigned int rep=0;rep<repetitions;rep++) {
+            std::ostringstream output;
+            auto start = std::chrono::steady_clock::now();
+            LearningProblem problem(file.getPath(),example.nofLines,example.safetyMode);
+            Learner learner(problem,example.uvwChainLength,paretoenumerator::DIMENSIONWISE,output);
+            learner.learn();
+            double milliseconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count()*1000.0;
+            if ((rep==0) || (milliseconds<result.milliseconds)) result.milliseconds = milliseconds;
+            result.outputHash = hashOutput(output.str());
+            result.nofOracleCalls = learner.getStatistics().nofOracleCalls;
+            result.nofChains = 0;
+            for (size_t pos = output.str().find("CHAIN");pos!=std::string::npos;pos = output.str().find("CHAIN",pos+1)) result.nofChains++;
+        }
+
+        // One more (untimed) run with group testing for comparing the numbers of oracle calls
+        {
+            std::ostringstream output;
+            LearningProblem problem(file.getPath(),example.nofLines,example.safetyMode);
+            Learner learner(problem,example.uvwChainLength,paretoenumerator::GROUPTESTING,output);
+            learner.learn();
+            result.outputHashGroupTesting = hashOutput(output.str());
+            result.nofOracleCallsGroupTesting = learner.getStatistics().nofOracleCalls;
+        }
+        results.push_back(result);
+    }
+
+    if (baselinePath!="") readBaseline(baselinePath,results);
+
+    // Print results
+    int returnValue = 0;
+    std::ostringstream json;
+    json << "{\"e2e\": [\n";
+    for (size_t i=0;i<results.size();i++) {
+        const EndToEndResult &result = results[i];
+        json << "  {\"name\": \"" << result.name << "\", \"ms\": " << result.milliseconds << ", \"chains\": " << result.nofChains << ", \"output_hash\": \"" << result.outputHash << "\"";
+        json << ", \"oracle_calls\": " << result.nofOracleCalls << ", \"oracle_calls_g\": " << result.nofOracleCallsGroupTesting;
+        if (result.outputHashGroupTesting!=result.outputHash) {
+            json << ", \"status_g\": \"output differs\"";
+            returnValue = 1;
+        }
+        if (result.baselineMilliseconds>=0.0) {
+            std::string status = "ok";
+            if (result.outputHash!=result.baselineOutputHash) {
+                status = "output differs";
+                returnValue = 1;
+            } else if ((result.milliseconds>result.baselineMilliseconds*(1.0+tolerance)) && (result.milliseconds>result.baselineMilliseconds+1.0)) {
+                status = "slower";
+                if (returnValue==0) returnValue = 2;
+            } else if (result.milliseconds<result.baselineMilliseconds*(1.0-tolerance)) {
+                status = "faster";
+            }
+            json << ", \"baseline_ms\": " << result.baselineMilliseconds << ", \"ratio\": " << result.milliseconds/result.baselineMilliseconds << ", \"status\": \"" << status << "\"";
+        } else if (baselinePath!="") {
+            json << ", \"status\": \"no baseline\"";
+        }
+        json << "}" << ((i+1<results.size())?",\n":"\n");
+    }
+    json << "]}\n";
+    std::cout << json.str();
+
+    if (writeBaselinePath!="") {
+        std::ofstream out(writeBaselinePath);
+        out << json.str();
+        if (out.fail()) throw "Error: Cannot write baseline file.";
+    }
+    return returnValue;
+}
+
+
+/**
+ * @brief Program entry point
+ * @param nofArgs
+ * @param args
+ * @return
+ */
+int main(int nofArgs, const char **args) {
+    try {
+        bool endToEnd = false;
+        std::string examplesDir = "../../examples";
+        std::string baselinePath = "";
+        std::string writeBaselinePath = "";
+        double tolerance = 0.25;
+        double minimalSeconds = 0.2;
+        unsigned int repetitions = 3;
+        for (int i=1;i<nofArgs;i++) {
+            std::string thisArg = args[i];
+            if (thisArg=="--e2e") {
+                endToEnd = true;
+            } else if ((thisArg=="--examples") || (thisArg=="--baseline") || (thisArg=="--write-baseline") || (thisArg=="--tolerance") || (thisArg=="--min-time") || (thisArg=="--repetitions")) {
+                if (i==nofArgs-1) throw std::string("Error: Require a value after '")+thisArg+"'";
+                std::string value = args[++i];
+                if (thisArg=="--examples") examplesDir = value;
+                else if (thisArg=="--baseline") baselinePath = value;
+                else if (thisArg=="--write-baseline") writeBaselinePath = value;
+                else {
+                    std::istringstream valueParser(value);
+                    if (thisArg=="--tolerance") valueParser >> tolerance;
+                    else if (thisArg=="--min-time") valueParser >> minimalSeconds;
+                    else valueParser >> repetitions;
+                    if (valueParser.fail()) throw std::string("Error: Required a valid number after '")+thisArg+"'";
+                }
+            } else {
+                throw std::string("Error: Did not understand parameter'")+thisArg+"'";
+            }
+        }
+
+        if (endToEnd) return runEndToEnd(examplesDir,baselinePath,writeBaselinePath,tolerance,repetitions);
+
+        BenchmarkRunner runner(minimalSeconds);
+        benchmarkParsing(runner);
+        benchmarkModelChecking(runner,examplesDir);
+        benchmarkResultBuffers(runner);
+        benchmarkCleanParetoFront(runner);
+        benchmarkSimulationFilter(runner);
+        runner.print(std::cout);
+        if (runner.sink==0) std::cerr << "(all benchmarked functions returned zero values)\n";
+
+    } catch (const char *error) {
+        std::cerr << error << std::endl;
+        return 1;
+    } catch (std::string error) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+#ifndef __FINITE_TRACE_ENGINE_HPP__
+#define __FINITE_TRACE_ENGINE_HPP__
+
+#include <vector>
+#include <cstdint>
+#include "learningProblem.hpp"
+
+/**
+ * @brief Model checking for the safety and finite-word modes. The positive examples are stored as a
+ * prefix trie, so that common prefixes of the examples are only processed once.
+ *
+ * In these modes, the lasso cycle of every example consists only of the "end of word" letter, on which
+ * only the final state of a chain has a (self-)transition. A chain hence rejects an example if and only
+ * if the final state is reachable at the end of the finite word. In the safety mode, the final state
+ * self-loops on all letters, so it suffices that the final state is reachable at any trie node, which
+ * takes care of the prefixes of the examples.
+ *
+ * The nodes are numbered such that parents come before their children. All runs are thus computed in
+ * a single forward pass over the nodes.
+ */
+class PrefixTrie {
+private:
+    unsigned int nofExamples;
+    std::vector<unsigned int> parents;
+    std::vector<unsigned int> letters;
+    std::vector<char> endOfExample;
+    std::vector<uint64_t> reachable;
+    std::vector<uint64_t> selfLoopStates;
+    std::vector<uint64_t> forwardStates;
+public:
+    PrefixTrie(const LearningProblem &problem);
+    inline size_t getNofNodes() const { return parents.size(); }
+    inline size_t getFootprint() const {
+        return sizeof(PrefixTrie)+(parents.capacity()+letters.capacity())*sizeof(unsigned int)+endOfExample.capacity()+(reachable.capacity()+selfLoopStates.capacity()+forwardStates.capacity())*sizeof(uint64_t);
+    }
+    bool acceptsAllExamples(const std::vector<int> &chain, unsigned int uvwChainLength, unsigned int nofLetters, SafetyMode safetyMode, std::vector<unsigned int> *rejectionCore = nullptr);
+private:
+    void computeRejectionCore(const std::vector<int> &chain, unsigned int uvwChainLength, unsigned int nofLetters, SafetyMode safetyMode, size_t node, std::vector<unsigned int> &rejectionCore) const;
+};
+
+
+/**
+ * @brief Builds the prefix trie from the (finite) positive examples of a learning problem
+ * @param problem the learning problem. Must not be a liveness problem, and its examples must not have been released.
+ */
+inline PrefixTrie::PrefixTrie(const LearningProblem &problem) : nofExamples(0) {
+    if (problem.hasReleasedExamples()) throw "Error: Cannot build a prefix trie from a learning problem whose examples have been released.";
+
+    // Root node = Empty word
+    parents.push_back(0);
+    letters.push_back(0);
+    endOfExample.push_back(false);
+
+    // The children of a node are kept in a linked list during construction. Node 0 is never a child,
+    // so it marks the end of a list.
+    std::vector<unsigned int> firstChild(1,0);
+    std::vector<unsigned int> nextSibling(1,0);
+    for (auto it = problem.begin();it!=problem.end();it++) {
+        unsigned int node = 0;
+        for (unsigned int character : it->first) {
+            unsigned int child = firstChild[node];
+            while ((child!=0) && (letters[child]!=character)) child = nextSibling[child];
+            if (child==0) {
+                child = parents.size();
+                parents.push_back(node);
+                letters.push_back(character);
+                endOfExample.push_back(false);
+                firstChild.push_back(0);
+                nextSibling.push_back(firstChild[node]);
+                firstChild[node] = child;
+            }
+            node = child;
+        }
+        endOfExample[node] = true;
+        nofExamples++;
+    }
+    parents.shrink_to_fit();
+    letters.shrink_to_fit();
+    endOfExample.shrink_to_fit();
+    reachable.resize(parents.size());
+}
+
+
+/**
+ * @brief Checks if no positive example is rejected by a chain
+ * @param chain the chain in the encoding of the Learner - a 0 represents a transition
+ * @param uvwChainLength the number of states in the chain
+ * @param nofLetters the number of letters, including the "end of word" letter
+ * @param safetyMode either SAFETY or FINITEWORDS
+ * @param rejectionCore if not NULL and some example is rejected, the indices of the chain elements used by a rejecting run are stored here
+ */
+inline bool PrefixTrie::acceptsAllExamples(const std::vector<int> &chain, unsigned int uvwChainLength, unsigned int nofLetters, SafetyMode safetyMode, std::vector<unsigned int> *rejectionCore) {
+
+    if (nofExamples==0) return true;
+
+    // Which states have a self-loop/forward transition for which letter?
+    selfLoopStates.assign(nofLetters,0);
+    forwardStates.assign(nofLetters,0);
+    for (unsigned int state=0;state<uvwChainLength;state++) {
+        for (unsigned int character=0;character<nofLetters;character++) {
+            if (!chain[2*state*nofLetters+character]) selfLoopStates[character] |= ((uint64_t)1) << state;
+            if ((state+1<uvwChainLength) && !chain[(2*state+1)*nofLetters+character]) forwardStates[character] |= ((uint64_t)1) << state;
+        }
+    }
+
+    uint64_t finalState = ((uint64_t)1) << (uvwChainLength-1);
+    bool safety = safetyMode==SAFETY;
+
+    reachable[0] = 1;
+    for (size_t node=0;node<parents.size();node++) {
+        if (node>0) {
+            uint64_t reachableBefore = reachable[parents[node]];
+            unsigned int character = letters[node];
+            reachable[node] = (reachableBefore & selfLoopStates[character]) | ((reachableBefore & forwardStates[character]) << 1);
+        }
+        if ((reachable[node] & finalState) && (safety || endOfExample[node])) {
+            if (rejectionCore!=nullptr) computeRejectionCore(chain,uvwChainLength,nofLetters,safetyMode,node,*rejectionCore);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * @brief Computes the chain elements used by a run that reaches the final state at a trie node, using the
+ * reachable states computed by the last call to acceptsAllExamples for the node and its ancestors.
+ *
+ * After the node, the run stays in the final state. In the safety mode, this uses the final self-loop for
+ * all letters (the remaining letters of the examples are not known here), and otherwise only for the
+ * "end of word" letter. These elements are fixed by the Learner anyway.
+ */
+inline void PrefixTrie::computeRejectionCore(const std::vector<int> &chain, unsigned int uvwChainLength, unsigned int nofLetters, SafetyMode safetyMode, size_t node, std::vector<unsigned int> &rejectionCore) const {
+    rejectionCore.clear();
+    unsigned int finalBlock = (2*uvwChainLength-2)*nofLetters;
+    if (safetyMode==SAFETY) {
+        for (unsigned int character=0;character<nofLetters;character++) rejectionCore.push_back(finalBlock+character);
+    } else {
+        rejectionCore.push_back(finalBlock+nofLetters-1);
+    }
+    unsigned int state = uvwChainLength-1;
+    while (node!=0) {
+        unsigned int character = letters[node];
+        node = parents[node];
+        if ((reachable[node] & (((uint64_t)1) << state)) && !chain[2*state*nofLetters+character]) {
+            rejectionCore.push_back(2*state*nofLetters+character);
+        } else {
+            state--;
+            rejectionCore.push_back((2*state+1)*nofLetters+character);
+        }
+    }
+}
+
+#endif
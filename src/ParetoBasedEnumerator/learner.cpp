@@ -0,0 +1,459 @@
+#include <iostream>
+#include <list>
+#include <vector>
+#include <set>
+#include "learner.hpp"
+
+
+/**
+ * @brief Estimates the memory used by a chain in a list of chains
+ */
+static size_t getFootprintOfChain(const std::vector<bool> &chain) {
+    return sizeof(std::vector<bool>)+2*sizeof(void*)+(chain.capacity()+7)/8;
+}
+
+
+Learner::Learner(const LearningProblem &_problem, unsigned int _maxUVWLength, paretoenumerator::MinimizationStrategy _minimizationStrategy, std::ostream &_out) : problem(_problem), maxUVWLength(_maxUVWLength), out(_out), minimizationStrategy(_minimizationStrategy) {
+
+    if (problem.hasReleasedExamples()) throw "Error: The examples of the learning problem have already been released.";
+    if (problem.getSafetyMode()!=LIVENESS) {
+        prefixTrie.reset(new PrefixTrie(problem));
+        memoryBudget.setFootprint(paretoenumerator::PREFIX_TRIE,prefixTrie->getFootprint());
+    } else {
+        size_t examplesFootprint = 0;
+        for (auto it = problem.begin();it!=problem.end();it++) {
+            examplesFootprint += sizeof(*it)+2*sizeof(void*)+(it->first.capacity()+it->second.capacity())*sizeof(unsigned int);
+            allCyclesNonEmpty &= !it->second.empty();
+        }
+        memoryBudget.setFootprint(paretoenumerator::EXAMPLES,examplesFootprint);
+    }
+}
+
+
+/**
+ * @brief Sets the memory limit for the caches of the enumeration. The examples (or the prefix trie built from them)
+ * need to fit into the limit, so that this is checked before the learning starts.
+ * @param bytes the limit, or 0 for no limit
+ */
+void Learner::setMemoryLimit(size_t bytes) {
+    size_t fixedFootprint = memoryBudget.getTotalFootprint();
+    if ((bytes>0) && (fixedFootprint>=bytes)) {
+        std::ostringstream error;
+        error << "Error: The memory limit needs to be larger than the " << fixedFootprint << " bytes (" << (fixedFootprint+1024*1024-1)/(1024*1024) << " MB) taken by the " << (prefixTrie?"prefix trie":"examples") << " alone.";
+        throw error.str();
+    }
+    memoryBudget.limit = bytes;
+}
+
+
+/**
+ * @brief Checks if no positive example is rejected by a chain
+ * @param chain the chain - having chain[...] = FALSE represents a transition in the UVW chain
+ * @param uvwChainLength the number of states in the chain
+ * @param rejectionCore if not NULL and some example is rejected, the indices of the chain elements used by a rejecting run are stored here
+ */
+bool Learner::acceptsAllExamples(const std::vector<int> &chain, unsigned int uvwChainLength, std::vector<unsigned int> *rejectionCore) {
+
+    // Safety and finite-word case: A single forward pass over the prefix trie of the examples suffices.
+    if (prefixTrie) return prefixTrie->acceptsAllExamples(chain,uvwChainLength,problem.getNofLetters(),problem.getSafetyMode(),rejectionCore);
+
+#ifndef NDEBUG
+    std::cerr << "Call: ";
+    for (auto it : chain) std::cerr << (it?"1":"0");
+    std::cerr << " ";
+#endif
+
+    // No that having chain[...] = FALSE represents a transition in the UVW chain.
+
+#ifndef NDEBUG
+    int rejectingLine = 0;
+#endif
+
+    for (auto it = problem.begin();it!=problem.end();it++) {
+        bool reject = true;
+
+        // std::cerr << "X" << it->second.size() << it->first.size();
+
+        // First check if the final state of this chain would accept
+        for (unsigned int ltrSuffix : it->second) {
+            if (chain[(2*uvwChainLength-2)*problem.getNofLetters()+ltrSuffix]) reject = false;
+        }
+
+        // std::cerr << "M" << reject;
+
+        if (reject) {
+            // So the cycle would be rejected. Ok, then let's see if it's reachable!
+
+            // First, prefix
+            uint64_t reachableLast = 1;
+            for (unsigned int character : it->first) {
+                uint64_t reachable = 0;
+                for (unsigned int state=0;state<uvwChainLength;state++) {
+                    if (((reachableLast & (1<<state))>0)) {
+                        // Self-cycle
+                        if (!chain[2*state*problem.getNofLetters()+character])  {
+                            reachable |= 1 << (state);
+                        }
+                        // Forward
+                        if (state+1<uvwChainLength) {
+                            if (!chain[2*state*problem.getNofLetters()+character+problem.getNofLetters()])  {
+                                reachable |= 1 << (state+1);
+                            }
+                        }
+                    }
+                }
+                reachableLast = reachable;
+            }
+
+            uint64_t reachableLoop = reachableLast;
+            uint64_t reachableLastLoop = 0;
+
+            // Saturate
+            while (reachableLoop!=reachableLastLoop) {
+
+                for (unsigned int character : it->second) {
+                    uint64_t reachable = 0;
+                    for (unsigned int state=0;state<uvwChainLength;state++) {
+                        if (((reachableLast & (1<<state))>0)) {
+                            // Self-cycle
+                            if (!chain[2*state*problem.getNofLetters()+character])  {
+                                reachable |= 1 << (state);
+                            }
+                            // Forward
+                            if (state+1<uvwChainLength) {
+                                if (!chain[2*state*problem.getNofLetters()+character+problem.getNofLetters()])  {
+                                    reachable |= 1 << (state+1);
+                                }
+                            }
+                        }
+                    }
+                    reachableLast = reachable;
+                }
+
+                reachableLastLoop = reachableLoop;
+                reachableLoop |= reachableLast;
+            }
+
+            // Model checking?
+            if (reachableLoop & (1<<(uvwChainLength-1))) {
+#ifndef NDEBUG
+                std::cerr << " reject" << rejectingLine << "\n";
+#endif
+                if (rejectionCore!=nullptr) computeRejectionCore(chain,uvwChainLength,*it,*rejectionCore);
+                return false;
+            }
+
+        }
+#ifndef NDEBUG
+        rejectingLine++;
+#endif
+    }
+#ifndef NDEBUG
+    std::cerr << " accept\n";
+#endif
+    return true;
+}
+
+
+/**
+ * @brief Computes the chain elements used by a run of a chain that rejects an example. Every chain that has
+ * (at least) these transitions rejects the example as well.
+ * @param chain the chain
+ * @param uvwChainLength the number of states in the chain
+ * @param example the rejected lasso-shaped example
+ * @param rejectionCore the indices of the chain elements are stored here
+ */
+void Learner::computeRejectionCore(const std::vector<int> &chain, unsigned int uvwChainLength, const std::pair<std::vector<unsigned int>,std::vector<unsigned int> > &example, std::vector<unsigned int> &rejectionCore) const {
+
+    unsigned int nofLetters = problem.getNofLetters();
+    uint64_t finalState = ((uint64_t)1) << (uvwChainLength-1);
+
+    // Reachable states after every character of the handle, followed by the cycle. States are never left
+    // to the left, so if the final state is reachable in the cycle, then it is reachable within
+    // "uvwChainLength" repetitions of the cycle.
+    std::vector<unsigned int> characters(example.first);
+    for (unsigned int i=0;i<uvwChainLength;i++) characters.insert(characters.end(),example.second.begin(),example.second.end());
+    std::vector<uint64_t> reachable(1,1);
+    for (unsigned int character : characters) {
+        uint64_t reachableBefore = reachable.back();
+        uint64_t reachableNow = 0;
+        for (unsigned int state=0;state<uvwChainLength;state++) {
+            if (reachableBefore & (((uint64_t)1) << state)) {
+                if (!chain[2*state*nofLetters+character]) reachableNow |= ((uint64_t)1) << state;
+                if ((state+1<uvwChainLength) && !chain[(2*state+1)*nofLetters+character]) reachableNow |= ((uint64_t)1) << (state+1);
+            }
+        }
+        reachable.push_back(reachableNow);
+    }
+
+    // Find the first point in the cycle part at which the final state is reachable. From there on, the run
+    // stays in the final state, for which it uses the final self-loop on the cycle characters.
+    size_t position = example.first.size();
+    while ((position<reachable.size()) && !(reachable[position] & finalState)) position++;
+    if (position==reachable.size()) throw "Error: Internal error - no rejecting run found for a rejected example.";
+    rejectionCore.clear();
+    for (unsigned int character : example.second) rejectionCore.push_back((2*uvwChainLength-2)*nofLetters+character);
+
+    // Backtrack a run to the final state
+    unsigned int state = uvwChainLength-1;
+    while (position>0) {
+        position--;
+        unsigned int character = characters[position];
+        if ((reachable[position] & (((uint64_t)1) << state)) && !chain[2*state*nofLetters+character]) {
+            rejectionCore.push_back(2*state*nofLetters+character);
+        } else {
+            state--;
+            rejectionCore.push_back((2*state+1)*nofLetters+character);
+        }
+    }
+}
+
+
+/**
+ * @brief Checks if a chain is simulated by a chain that has been found earlier, so that it does not need to be reported
+ * @param chain the chain
+ * @param uvwChainLength the number of states in the chain
+ */
+bool Learner::isSimulatedByPastChain(const std::vector<int> &chain, unsigned int uvwChainLength) const {
+
+    unsigned int nof= 0;
+    for (auto &it : pastChains) {
+        nof++;
+
+        // Simulation at the last element
+        bool sim = true;
+        for (unsigned int j=0;j<problem.getNofLetters();j++) {
+            sim &= (chain[chain.size()-problem.getNofLetters()+j]>0) || it[it.size()-problem.getNofLetters()+j]==0;
+            //std::cerr << "p: " << chain.size()-problem.getNofLetters()+j << std::endl;
+            //std::cerr << "Q: " << it.size()-problem.getNofLetters()+j << std::endl;
+        }
+
+        // Other simulation elements
+        if (sim) {
+            std::list<std::pair<unsigned int,unsigned int> > todo; todo.push_back(std::pair<int,int>(0,0));
+            std::set<std::pair<unsigned int,unsigned int> > done; done.insert(std::pair<int,int>(0,0));
+            while (todo.size()!=0) {
+                std::pair<int,int> thisOne = todo.front();
+                todo.pop_front();
+                //std::cerr << "M " << thisOne.first << "," << thisOne.second << "\n";
+
+                // Check if staying is possible.
+                bool stay = true;
+                for (unsigned int j=0;j<problem.getNofLetters();j++) {
+                    stay &= chain[thisOne.first*problem.getNofLetters()*2+j] || !it[(thisOne.second*2)*problem.getNofLetters()+j];
+                }
+                //std::cerr << "S" << stay << std::endl;
+
+                if ((stay) && (thisOne.first < (int)uvwChainLength-1)) {
+
+                    // Check if we can move one forward
+                    bool front = true;
+                    for (unsigned int j=0;j<problem.getNofLetters();j++) {
+                        front &= chain[(thisOne.first*2+1)*problem.getNofLetters()+j] || !it[(thisOne.second*2)*problem.getNofLetters()+j];
+                    }
+                    //std::cerr << "F" << front << std::endl;
+
+                    if (front) {
+                        std::pair<int,int> next(thisOne.first+1,thisOne.second);
+                        if (done.count(next)==0) {
+                            todo.push_back(next);
+                            done.insert(next);
+                        }
+                    }
+
+                    // Check if we can move two forward
+                    if (thisOne.second < (int)(it.size()/problem.getNofLetters()/2)) {
+
+                        bool both = true;
+                        for (unsigned int j=0;j<problem.getNofLetters();j++) {
+                            both &= chain[(thisOne.first*2+1)*problem.getNofLetters()+j] || !it[(thisOne.second*2+1)*problem.getNofLetters()+j];
+                        }
+                        if (both) {
+                            std::pair<int,int> next(thisOne.first+1,thisOne.second+1);
+                            if (done.count(next)==0) {
+                                todo.push_back(next);
+                                done.insert(next);
+                            }
+                        }
+                    }
+                }
+
+            }
+
+            if (done.count(std::pair<int,int>(uvwChainLength-1,it.size()/problem.getNofLetters()/2))>0) {
+
+                /*std::cout << "NOCHAIN(" << nof << ")";
+                for (unsigned int i=0;i<2*uvwChainLength-1;i++) {
+                    std::cout << " ";
+                    for (unsigned int j=0;j<problem.getNofLetters();j++) {
+                        std::cout << (chain[i*problem.getNofLetters()+j]?'0':'1');
+                    }
+                }
+                std::cout << "\n";*/
+
+
+                return true;
+            }
+        }
+
+    }
+    return false;
+}
+
+
+/**
+ * @brief Reports a chain found by the Pareto front enumeration, unless it has an empty part or is simulated by an older chain
+ * @param chain the chain
+ * @param uvwChainLength the number of states in the chain
+ */
+void Learner::reportChain(const std::vector<int> &chain, unsigned int uvwChainLength) {
+
+    // Test if any of the parts is the empty set
+    bool nonEmpty = true;
+    for (unsigned int i=1;i<2*uvwChainLength-1;i+=2) {
+        bool thisOne = false;
+        for (unsigned int j=0;j<problem.getNofLetters();j++) {
+            thisOne |= chain[i*problem.getNofLetters()+j]==0;
+        }
+        nonEmpty &= thisOne;
+    }
+
+    // Loop empty?
+    bool thisOne = false;
+    for (unsigned int j=0;j<problem.getNofLetters();j++) {
+        thisOne |= chain[(uvwChainLength-1)*2*problem.getNofLetters()+j]==0;
+    }
+    nonEmpty &= thisOne;
+
+    if (nonEmpty) {
+
+        // Check simulation by an older chain
+        if (isSimulatedByPastChain(chain,uvwChainLength)) return;
+
+        out << "CHAIN";
+        for (unsigned int i=0;i<2*uvwChainLength-1;i++) {
+            out << " ";
+            for (unsigned int j=0;j<problem.getNofLetters();j++) {
+                out << (chain[i*problem.getNofLetters()+j]?'0':'1');
+            }
+        }
+        out << "\n";
+    }
+
+    pastChains.push_back(std::vector<bool>(chain.begin(),chain.end()));
+    pastChainsFootprint += getFootprintOfChain(pastChains.back());
+    memoryBudget.setFootprint(paretoenumerator::PAST_CHAINS,pastChainsFootprint);
+}
+
+
+/**
+ * @brief Maps the chains with known model checking results to chains with one more state.
+ *
+ * Duplicating the final state of a chain (so that the old final state gets the final state's self-loop
+ * as self-loop and as forward transition) does not change the set of words rejected by the chain, so that
+ * both feasible and infeasible chains stay feasible and infeasible, respectively. Duplicating a non-final
+ * state (so that the state moves to its copy on the self-loop letters) can only make the set of rejected
+ * words smaller, so that this is only done for the feasible chains.
+ *
+ * Examples with an empty cycle are an exception: they are rejected if the final state is reachable at the
+ * end of the handle, and reaching the new final state takes one more letter. Duplicating the final state
+ * can then also only make the set of rejected words smaller, so that infeasible chains are only mapped if
+ * all examples have a non-empty cycle.
+ * @param knownResults the mapped chains are added to this object
+ */
+void Learner::embedKnownResults(paretoenumerator::KnownResults &knownResults) const {
+
+    unsigned int nofLetters = problem.getNofLetters();
+    unsigned int nofBlocks = 2*knownResultsChainLength-1;
+
+    auto duplicateFinalState = [nofLetters,nofBlocks](const std::vector<bool> &chain) {
+        std::vector<int> result(chain.begin(),chain.end());
+        for (unsigned int i=0;i<2;i++) result.insert(result.end(),chain.begin()+(nofBlocks-1)*nofLetters,chain.end());
+        return result;
+    };
+
+    for (auto const &chain : knownFeasibleChains) {
+        knownResults.feasiblePoints.push_back(duplicateFinalState(chain));
+        for (unsigned int state=0;state+1<knownResultsChainLength;state++) {
+            std::vector<int> result(chain.begin(),chain.begin()+(2*state+1)*nofLetters);
+            for (unsigned int i=0;i<2;i++) result.insert(result.end(),chain.begin()+2*state*nofLetters,chain.begin()+(2*state+1)*nofLetters);
+            result.insert(result.end(),chain.begin()+(2*state+1)*nofLetters,chain.end());
+            knownResults.feasiblePoints.push_back(result);
+        }
+    }
+    if (allCyclesNonEmpty) {
+        for (auto const &chain : knownInfeasibleChains) {
+            knownResults.infeasiblePoints.push_back(duplicateFinalState(chain));
+        }
+    }
+}
+
+
+/**
+ * @brief Keeps the chains with known model checking results after the enumeration for some chain length,
+ * unless this exceeds the memory limit.
+ */
+void Learner::storeKnownResults(const paretoenumerator::KnownResults &knownResults, unsigned int uvwChainLength) {
+    for (auto const &chain : knownResults.feasiblePoints) {
+        knownFeasibleChains.push_back(std::vector<bool>(chain.begin(),chain.end()));
+        knownResultsFootprint += getFootprintOfChain(knownFeasibleChains.back());
+    }
+    for (auto const &chain : knownResults.infeasiblePoints) {
+        knownInfeasibleChains.push_back(std::vector<bool>(chain.begin(),chain.end()));
+        knownResultsFootprint += getFootprintOfChain(knownInfeasibleChains.back());
+    }
+    knownResultsChainLength = uvwChainLength;
+    memoryBudget.setFootprint(paretoenumerator::KNOWN_RESULTS,knownResultsFootprint);
+    if (memoryBudget.isExceeded()) {
+        clearKnownResults();
+        memoryBudget.nofCacheShrinks++;
+    }
+}
+
+
+void Learner::clearKnownResults() {
+    knownFeasibleChains.clear();
+    knownInfeasibleChains.clear();
+    knownResultsFootprint = 0;
+    memoryBudget.setFootprint(paretoenumerator::KNOWN_RESULTS,0);
+}
+
+
+void Learner::learn(unsigned int uvwChainLength) {
+
+    if (uvwChainLength>63) throw "Error: Due to optimziations in the code, no UVW chain lengths >63 are supported.";
+
+    unsigned int nofBitsPerChain = problem.getNofLetters()*(2*uvwChainLength-1);
+    std::vector<std::pair<int,int> > limits(nofBitsPerChain);
+    for (unsigned int i=0;i<nofBitsPerChain;i++) limits[i] = std::pair<int,int>(0,1);
+
+    // Safety case: Modify limits so that the "end of word" character is the only one in the loop, and only there.
+    if (problem.getSafetyMode()!=LIVENESS) {
+        for (unsigned int i=0;i<2*uvwChainLength-1;i++) {
+            limits[i*problem.getNofLetters()+problem.getNofLetters()-1] = std::pair<int,int>(1,1);
+        }
+        for (unsigned int i=0;i<problem.getNofLetters()-1;i++) {
+            limits[problem.getNofLetters()*(2*uvwChainLength-2)+i] = (problem.getSafetyMode()==FINITEWORDS)?std::pair<int,int>(1,1):std::pair<int,int>(0,0);
+        }
+        limits[limits.size()-1] = std::pair<int,int>(0,0);
+    }
+
+    // Define model checking function
+    paretoenumerator::FeasibilityFunctionWithCore modelCheckingFn = [this,uvwChainLength](const std::vector<int> &chain, std::vector<unsigned int> &rejectionCore) {
+        return acceptsAllExamples(chain,uvwChainLength,&rejectionCore);
+    };
+
+    // Define callback function
+    std::function<void(const std::vector<int> &)> callbackFn = [this,uvwChainLength](const std::vector<int> &chain) {
+        reportChain(chain,uvwChainLength);
+    };
+
+    // Warm start from the results for the previous chain length
+    paretoenumerator::KnownResults knownResults;
+    if ((knownResultsChainLength>0) && (knownResultsChainLength+1==uvwChainLength)) embedKnownResults(knownResults);
+    clearKnownResults();
+
+    paretoenumerator::enumerateParetoFront(callbackFn,modelCheckingFn,limits,minimizationStrategy,&statistics,&knownResults,&memoryBudget);
+    storeKnownResults(knownResults,uvwChainLength);
+
+}
@@ -0,0 +1,50 @@
+#ifndef __LEARNER_HPP__
+#define __LEARNER_HPP__
+
+#include <list>
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <fstream>
+#include "tools.hpp"
+#include "pareto_enumerator.hpp"
+#include "learningProblem.hpp"
+#include "finiteTraceEngine.hpp"
+
+
+class Learner {
+private:
+    const LearningProblem &problem;
+    unsigned int maxUVWLength;
+    std::ostream &out;
+    std::list<std::vector<bool> > pastChains;
+    size_t pastChainsFootprint = 0;
+    paretoenumerator::MinimizationStrategy minimizationStrategy;
+    paretoenumerator::EnumerationStatistics statistics;
+    std::unique_ptr<PrefixTrie> prefixTrie; // Only used in the safety and finite-word modes
+    std::list<std::vector<bool> > knownFeasibleChains; // Chains of length "knownResultsChainLength" for which the model checking result is known
+    std::list<std::vector<bool> > knownInfeasibleChains;
+    unsigned int knownResultsChainLength = 0;
+    bool allCyclesNonEmpty = true; // Cycles of examples can be empty in the liveness mode
+    size_t knownResultsFootprint = 0;
+    paretoenumerator::MemoryBudget memoryBudget;
+    void embedKnownResults(paretoenumerator::KnownResults &knownResults) const;
+    void storeKnownResults(const paretoenumerator::KnownResults &knownResults, unsigned int uvwChainLength);
+    void clearKnownResults();
+public:
+    Learner(const LearningProblem &_problem, unsigned int _maxUVWLength, paretoenumerator::MinimizationStrategy _minimizationStrategy, std::ostream &_out);
+    void learn(unsigned int uvwChainLength);
+    void learn() {
+        for (unsigned int i=1;i<=maxUVWLength;i++) learn(i);
+    }
+    bool acceptsAllExamples(const std::vector<int> &chain, unsigned int uvwChainLength, std::vector<unsigned int> *rejectionCore = nullptr);
+    void computeRejectionCore(const std::vector<int> &chain, unsigned int uvwChainLength, const std::pair<std::vector<unsigned int>,std::vector<unsigned int> > &example, std::vector<unsigned int> &rejectionCore) const;
+    bool isSimulatedByPastChain(const std::vector<int> &chain, unsigned int uvwChainLength) const;
+    void reportChain(const std::vector<int> &chain, unsigned int uvwChainLength);
+    const paretoenumerator::EnumerationStatistics &getStatistics() const { return statistics; }
+    void setMemoryLimit(size_t bytes);
+    const paretoenumerator::MemoryBudget &getMemoryBudget() const { return memoryBudget; }
+};
+
+#endif
@@ -11,6 +11,7 @@ private:
     unsigned int nofBitsPerLetter;
     unsigned int nofLetters;
     SafetyMode safetyMode;
+    bool examplesReleased;
     std::list<std::pair<std::vector<unsigned int>,std::vector<unsigned int> > > positiveExamples;
 public:
     LearningProblem(std::string &inputFileName, int numberOfLines, SafetyMode _safetyMode);
@@ -19,6 +20,8 @@ public:
     inline SafetyMode getSafetyMode() const { return safetyMode; }
     inline std::list<std::pair<std::vector<unsigned int>,std::vector<unsigned int> > >::const_iterator begin() const { return positiveExamples.begin(); }
     inline std::list<std::pair<std::vector<unsigned int>,std::vector<unsigned int> > >::const_iterator end() const { return positiveExamples.end(); }
+    inline bool hasReleasedExamples() const { return examplesReleased; }
+    inline void releaseExamples() { positiveExamples.clear(); examplesReleased = true; }
 };
 
 
@@ -26,7 +29,7 @@ public:
  * @brief Loads a learning problem from disk
  * @param inputFileName
  */
-inline LearningProblem::LearningProblem(std::string &inputFileName, int numberOfLines, SafetyMode _safetyMode) {
+inline LearningProblem::LearningProblem(std::string &inputFileName, int numberOfLines, SafetyMode _safetyMode) : examplesReleased(false) {
 
     std::ifstream inFile(inputFileName);
     if (inFile.fail()) throw "Error opening input file";
@@ -115,6 +118,7 @@ inline LearningProblem::LearningProblem(std::string &inputFileName, int numberOf
 
                 // Insert suffix
                 cycle.push_back(nofLetters);
+                prefix.shrink_to_fit();
             }
         }
 
@@ -204,7 +208,8 @@ inline LearningProblem::LearningProblem(std::string &inputFileName, int numberOf
                         letter = 0;
                     }
                 }
-
+                prefix.shrink_to_fit();
+                cycle.shrink_to_fit();
 
             }
         }
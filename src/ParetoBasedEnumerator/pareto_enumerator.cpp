@@ -1,4 +1,9 @@
 #include "pareto_enumerator.hpp"
+#include "result_buffers.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <unordered_map>
 
 /*
  * This is
@@ -86,117 +91,518 @@ namespace paretoenumerator {
 
 
     /**
-     * @brief A class that buffers negative results from the feasibility function so that no
-     * redundant calls are made to it.
+     * @brief Removes all points from a set of encoded search space points for which the set contains a strictly larger point.
+     * This is the counterpart of "cleanParetoFront" for the co-Pareto set, and keeps the order of the remaining points.
+     * @param input The initial set of points
+     * @param output The remaining points are added to this list
+     */
+    void cleanCoParetoSet(const FlatPointList &input, FlatPointList &output, const PointEncoding &encoding) {
+        for (size_t i=0;i<input.size();i++) {
+            bool foundLarger = false;
+            for (size_t j=0;j<input.size();j++) {
+                if (encoding.isLeq(input.getData(i),input.getData(j)) && !encoding.isEqual(input.getData(i),input.getData(j))) {
+                    foundLarger = true;
+                    break;
+                }
+            }
+            if (!foundLarger) output.add(input.getData(i));
+        }
+    }
+
+
+    /**
+     * @brief Hash function for encoded search space points, so that they can be used in an unordered_map
+     */
+    class EncodedPointHash {
+    public:
+        size_t operator()(const std::vector<uint64_t> &data) const {
+            size_t hash = data.size();
+            for (uint64_t a : data) {
+                hash ^= static_cast<size_t>(a ^ (a >> 32)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            }
+            return hash;
+        }
+    };
+
+
+    /**
+     * @brief Puts an exact-point memo table and the buffers for negative and positive results in front
+     * of the feasibility function. The memo table is checked first as a lookup in it is cheap. The
+     * buffers then also cover all points that are dominated by or that dominate a point with a known result.
+     *
+     * For a negative result, the largest point that agrees with the tested point in the core dimensions
+     * reported by the feasibility function is added to the negative result buffer.
      *
-     * Dominated points are removed from the buffer
+     * If a memory budget is given, it is checked after every insertion into the memo table or the buffers,
+     * and the caches are shrunk whenever it is exceeded.
      */
-    class NegativeResultBuffer {
-        std::list<std::vector<int> > oldValueBuffer;
+    class CachedFeasibilityFunction {
+        FeasibilityFunctionWithCore &fn;
+        const std::vector<std::pair<int,int> > &limits;
+        EnumerationStatistics &statistics;
+        MemoryBudget *memoryBudget;
+        PointEncoding encoding;
+        std::unordered_map<std::vector<uint64_t>,bool,EncodedPointHash> memo;
+        NegativeResultBuffer negativeResultBuffer;
+        PositiveResultBuffer positiveResultBuffer;
+        std::vector<uint64_t> encoded;
+        std::vector<unsigned int> core;
+        std::vector<int> generalizedPoint;
+
+        // Reports the memory footprints of the memo table and the buffers
+        void reportFootprints() const {
+            size_t memoEntrySize = sizeof(std::pair<const std::vector<uint64_t>,bool>)+2*sizeof(void*)+encoding.getNofWords()*sizeof(uint64_t);
+            memoryBudget->setFootprint(MEMO_TABLE,memo.size()*memoEntrySize+memo.bucket_count()*sizeof(void*));
+            memoryBudget->setFootprint(NEGATIVE_RESULT_BUFFER,negativeResultBuffer.getPoints().getFootprint());
+            memoryBudget->setFootprint(POSITIVE_RESULT_BUFFER,positiveResultBuffer.getPoints().getFootprint());
+        }
+
+        // Empties the memo table or, if it is already empty, drops half of the points in one of the buffers.
+        // Returns false if all caches are empty already.
+        bool shrink() {
+            if (!memo.empty()) {
+                std::unordered_map<std::vector<uint64_t>,bool,EncodedPointHash>().swap(memo);
+            } else if (positiveResultBuffer.getPoints().size()>0) {
+                positiveResultBuffer.getPoints().truncate(positiveResultBuffer.getPoints().size()/2);
+            } else if (negativeResultBuffer.getPoints().size()>0) {
+                negativeResultBuffer.getPoints().truncate(negativeResultBuffer.getPoints().size()/2);
+            } else {
+                return false;
+            }
+            return true;
+        }
+
     public:
-        bool isContained(const std::vector<int> &data) {
-            for (auto const &a : oldValueBuffer) {
-                if (vectorOfIntIsLeq(data,a)) return true;
+        CachedFeasibilityFunction(FeasibilityFunctionWithCore &_fn, const std::vector<std::pair<int,int> > &_limits, EnumerationStatistics &_statistics, MemoryBudget *_memoryBudget) : fn(_fn), limits(_limits), statistics(_statistics), memoryBudget(_memoryBudget), encoding(_limits), negativeResultBuffer(encoding), positiveResultBuffer(encoding) {}
+
+        // Updates the footprints of the caches in the memory budget (if any) and shrinks the caches until the
+        // budget is met again. The footprints are computed in constant time, so that this can be done after every insertion.
+        void enforceMemoryBudget() {
+            if (memoryBudget==nullptr) return;
+            reportFootprints();
+            if (memoryBudget->limit==0) return;
+            while (memoryBudget->isExceeded()) {
+                if (!shrink()) {
+                    std::ostringstream error;
+                    error << "Error: Memory limit exceeded after emptying all caches. ";
+                    memoryBudget->print(error,false);
+                    std::string message = error.str();
+                    throw message.substr(0,message.size()-1);
+                }
+                memoryBudget->nofCacheShrinks++;
+                reportFootprints();
             }
-            return false;
         }
 
-        void addPoint(const std::vector<int> &data) {
-            for (auto it = oldValueBuffer.begin();it!=oldValueBuffer.end();) {
-                if (vectorOfIntIsLeq(*it,data)) {
-                    it = oldValueBuffer.erase(it);
+        bool operator()(const std::vector<int> &data) {
+            encoding.encode(data,encoded);
+            auto it = memo.find(encoded);
+            if (it!=memo.end()) {
+                statistics.nofMemoHits++;
+                return it->second;
+            }
+            if (negativeResultBuffer.isContained(encoded.data())) {
+                statistics.nofNegativeBufferHits++;
+                return false;
+            }
+            if (positiveResultBuffer.isContained(encoded.data())) {
+                statistics.nofPositiveBufferHits++;
+                return true;
+            }
+            statistics.nofOracleCalls++;
+            core.resize(data.size());
+            for (unsigned int i=0;i<data.size();i++) core[i] = i;
+            bool result = fn(data,core);
+            memo[encoded] = result;
+            if (result) {
+                positiveResultBuffer.addPoint(encoded.data());
+            } else if (core.size()==data.size()) {
+                negativeResultBuffer.addPoint(encoded.data());
+            } else {
+                generalizedPoint.resize(data.size());
+                for (unsigned int i=0;i<data.size();i++) generalizedPoint[i] = limits[i].second;
+                for (unsigned int i : core) generalizedPoint[i] = data[i];
+                if (generalizedPoint!=data) statistics.nofGeneralizedNegativeResults++;
+                negativeResultBuffer.addPoint(generalizedPoint);
+            }
+            enforceMemoryBudget();
+            return result;
+        }
+
+        // Adds a point whose value of the feasibility function is known from elsewhere to the buffers
+        void addKnownResult(const std::vector<int> &data, bool result) {
+            statistics.nofKnownResultsUsed++;
+            if (result) {
+                positiveResultBuffer.addPoint(data);
+            } else {
+                negativeResultBuffer.addPoint(data);
+            }
+            enforceMemoryBudget();
+        }
+
+        // Stores the points in the buffers, which are all minimal feasible and maximal infeasible points found so far
+        void getKnownResults(KnownResults &knownResults) const {
+            knownResults.feasiblePoints.clear();
+            knownResults.infeasiblePoints.clear();
+            for (size_t i=0;i<positiveResultBuffer.getPoints().size();i++) knownResults.feasiblePoints.push_back(positiveResultBuffer.getPoints().getPoint(i));
+            for (size_t i=0;i<negativeResultBuffer.getPoints().size();i++) knownResults.infeasiblePoints.push_back(negativeResultBuffer.getPoints().getPoint(i));
+        }
+    };
+
+
+    void EnumerationStatistics::print(std::ostream &os) const {
+        os << "Oracle calls: " << nofOracleCalls << ", memo hits: " << nofMemoHits;
+        os << ", negative buffer hits: " << nofNegativeBufferHits << ", positive buffer hits: " << nofPositiveBufferHits;
+        os << ", known results used: " << nofKnownResultsUsed << ", generalized negative results: " << nofGeneralizedNegativeResults << "\n";
+    }
+
+
+    static const char *memoryBudgetItemNames[NOF_MEMORY_BUDGET_ITEMS] = {"examples","prefix trie","past chains","known results","co-Pareto set","memo table","negative result buffer","positive result buffer"};
+
+    size_t MemoryBudget::getTotalFootprint() const {
+        size_t total = 0;
+        for (size_t bytes : footprints) total += bytes;
+        return total;
+    }
+
+    void MemoryBudget::print(std::ostream &os, bool peak) const {
+        os << (peak?"Peak memory footprints":"Memory footprints") << " (in bytes): ";
+        for (unsigned int i=0;i<NOF_MEMORY_BUDGET_ITEMS;i++) {
+            if (used[i]) os << memoryBudgetItemNames[i] << ": " << (peak?peakFootprints[i]:footprints[i]) << ", ";
+        }
+        os << "cache shrinks: " << nofCacheShrinks << "\n";
+    }
+
+
+    /**
+     * @brief Moves points with known values of the feasibility function into the search space. As the function is
+     * monotone, feasible points may only be moved up and infeasible points may only be moved down for this purpose.
+     * Points that cannot be moved into the search space in this way are removed.
+     */
+    void moveIntoSearchSpace(std::list<std::vector<int> > &points, const std::vector<std::pair<int,int> > &limits, bool feasible) {
+        auto it = points.begin();
+        while (it!=points.end()) {
+            bool keep = it->size()==limits.size();
+            for (unsigned int i=0;keep && (i<limits.size());i++) {
+                int &value = (*it)[i];
+                if (feasible) {
+                    if (value>limits[i].second) {
+                        keep = false;
+                    } else if (value<limits[i].first) {
+                        value = limits[i].first;
+                    }
                 } else {
-                    it++;
+                    if (value<limits[i].first) {
+                        keep = false;
+                    } else if (value>limits[i].second) {
+                        value = limits[i].second;
+                    }
                 }
             }
-            oldValueBuffer.push_back(data);
+            if (keep) {
+                it++;
+            } else {
+                it = points.erase(it);
+            }
+        }
+    }
+
+
+    /**
+     * @brief Lowers the value of a feasible point in one dimension as far as possible by binary search
+     */
+    void minimizeDimension(std::vector<int> &x, unsigned int i, const std::vector<std::pair<int,int> > &limits, CachedFeasibilityFunction &cachedFn) {
+        int max = x[i]+1;
+        int min = limits[i].first;
+        while ((max - min)>1) {
+            int mid = min + ((max-min-1)/2);
+            x[i] = mid;
+            if (cachedFn(x)) {
+                max = mid+1;
+            } else {
+                min = mid+1;
+            }
+        }
+        x[i] = min;
+    }
+
+
+    /**
+     * @brief Lowers a feasible point to a Pareto point by performing a binary search in one dimension after the other
+     * @param x the point to be lowered
+     * @param limits the limits of the search space
+     * @param cachedFn the feasibility function
+     */
+    void minimizeDimensionwise(std::vector<int> &x, const std::vector<std::pair<int,int> > &limits, CachedFeasibilityFunction &cachedFn) {
+        for (unsigned int i=0;i<x.size();i++) {
+            minimizeDimension(x,i,limits,cachedFn);
+        }
+    }
+
+
+    /**
+     * @brief Lowers a feasible point to the same Pareto point as "minimizeDimensionwise", but lowers consecutive
+     * dimensions whose value is only one above the lower limit together (adaptive group testing).
+     *
+     * If lowering a block of such dimensions together is feasible, then lowering them one after the other would
+     * have been feasible, too. Otherwise, a bisection finds the first dimension in the block that needs to stay
+     * at its value. The block size is chosen by generalized binary splitting, based on the fraction of
+     * dimensions that stayed at their value in the previous calls. If more than about half of the dimensions
+     * are expected to stay, the block size is 1, which makes this the same as "minimizeDimensionwise".
+     *
+     * On the examples selected for "benchmark --e2e", this saves only about 10-20% of the oracle calls (and
+     * almost none for long runs), as most dimensions stay at their value and most single-dimension tests are
+     * answered by the result buffers anyway. Also, the oracle calls for testing the points of the co-Pareto set
+     * are not affected.
+     */
+    class GroupTestingMinimizer {
+        unsigned long nofStayed = 0;
+        unsigned long nofLowered = 0;
+
+        void lower(std::vector<int> &x, const std::vector<unsigned int> &run, size_t from, size_t to) {
+            for (size_t i=from;i<to;i++) x[run[i]]--;
+        }
+        void raise(std::vector<int> &x, const std::vector<unsigned int> &run, size_t from, size_t to) {
+            for (size_t i=from;i<to;i++) x[run[i]]++;
+        }
+
+        // Number of dimensions to be tested together if "nofLeft" dimensions are left in the run
+        size_t blockSize(size_t nofLeft) const {
+            double estimatedStaying = nofLeft*(nofStayed+1.0)/(nofStayed+nofLowered+2.0);
+            if (estimatedStaying<1.0) estimatedStaying = 1.0;
+            if (nofLeft<=2*estimatedStaying-2) return 1;
+            size_t size = 1;
+            while (2*size<=(nofLeft-estimatedStaying+1)/estimatedStaying) size *= 2;
+            return std::min(size,nofLeft);
+        }
+
+        void minimizeRun(std::vector<int> &x, const std::vector<unsigned int> &run, CachedFeasibilityFunction &cachedFn) {
+            size_t pos = 0;
+            while (pos<run.size()) {
+                size_t end = pos+blockSize(run.size()-pos);
+                lower(x,run,pos,end);
+                if (cachedFn(x)) {
+                    nofLowered += end-pos;
+                    pos = end;
+                } else {
+                    raise(x,run,pos,end);
+                    // Find the first dimension that needs to stay. Lowering the dimensions [lo,hi) is
+                    // known to be infeasible, and all dimensions in [pos,lo) can be lowered.
+                    size_t lo = pos;
+                    size_t hi = end;
+                    while (hi-lo>1) {
+                        size_t mid = lo+(hi-lo)/2;
+                        lower(x,run,lo,mid);
+                        if (cachedFn(x)) {
+                            lo = mid;
+                        } else {
+                            raise(x,run,lo,mid);
+                            hi = mid;
+                        }
+                    }
+                    nofLowered += lo-pos;
+                    nofStayed++;
+                    pos = lo+1;
+                }
+            }
+        }
+
+    public:
+        void minimize(std::vector<int> &x, const std::vector<std::pair<int,int> > &limits, CachedFeasibilityFunction &cachedFn) {
+            std::vector<unsigned int> run;
+            for (unsigned int i=0;i<x.size();i++) {
+                if (x[i]==limits[i].first) {
+                    // Nothing to lower here
+                } else if (x[i]==limits[i].first+1) {
+                    run.push_back(i);
+                } else {
+                    minimizeRun(x,run,cachedFn);
+                    run.clear();
+                    minimizeDimension(x,i,limits,cachedFn);
+                }
+            }
+            minimizeRun(x,run,cachedFn);
         }
     };
 
 
+    /**
+     * @brief Variant of the main function for feasibility functions that do not explain negative results
+     */
+    void enumerateParetoFront(std::function<void(const std::vector<int> &)> callBack, std::function<bool(const std::vector<int> &)> fn, const std::vector<std::pair<int,int> > &limits, MinimizationStrategy strategy, EnumerationStatistics *statistics, KnownResults *knownResults, MemoryBudget *memoryBudget) {
+        FeasibilityFunctionWithCore fnWithCore = [&fn](const std::vector<int> &point, std::vector<unsigned int> &) { return fn(point); };
+        enumerateParetoFront(callBack,fnWithCore,limits,strategy,statistics,knownResults,memoryBudget);
+    }
+
+
     /**
      * @brief Main function of the pareto front element enumeration algorithm
-     * @param fn the feasibility function
+     * @param fn the feasibility function, which may reduce the set of dimensions in its second parameter to a
+     *        core of dimensions that suffice to make the point infeasible when it returns false
      * @param limits the upper and lower bounds of the objective values. In every pair, the minimal value comes first.
+     *        Dimensions for which both values are the same are projected away before the enumeration.
+     * @param strategy the way in which feasible points are lowered to Pareto points
+     * @param statistics if not NULL, the numbers of calls to fn and of cache hits are added to this object
+     * @param knownResults if not NULL, points for which the value of fn is known. After the enumeration, the
+     *        object contains the minimal feasible and maximal infeasible points with known values.
+     * @param memoryBudget if not NULL, the footprints of the data structures of the enumeration are reported to this
+     *        object, and the caches are shrunk whenever the limit of the budget is exceeded
      */
-    void enumerateParetoFront(std::function<void(const std::vector<int> &)> callBack, std::function<bool(const std::vector<int> &)> fn, const std::vector<std::pair<int,int> > &limits) {
+    void enumerateParetoFront(std::function<void(const std::vector<int> &)> callBack, FeasibilityFunctionWithCore fn, const std::vector<std::pair<int,int> > &limits, MinimizationStrategy strategy, EnumerationStatistics *statistics, KnownResults *knownResults, MemoryBudget *memoryBudget) {
+
+        if (knownResults!=nullptr) {
+            moveIntoSearchSpace(knownResults->feasiblePoints,limits,true);
+            moveIntoSearchSpace(knownResults->infeasiblePoints,limits,false);
+        }
+
+        // Dimensions in which the lower and the upper limit coincide are not part of the search space.
+        // If there are any, we enumerate over the remaining dimensions and expand the points for "fn" and "callBack".
+        std::vector<unsigned int> freeDimensions;
+        for (unsigned int i=0;i<limits.size();i++) {
+            if (limits[i].first!=limits[i].second) freeDimensions.push_back(i);
+        }
+        if (freeDimensions.size()<limits.size()) {
+            std::vector<std::pair<int,int> > projectedLimits;
+            std::vector<int> expandedPoint;
+            for (auto const &i : limits) expandedPoint.push_back(i.first);
+            for (unsigned int i : freeDimensions) projectedLimits.push_back(limits[i]);
+            auto expand = [&freeDimensions,&expandedPoint](const std::vector<int> &point) -> const std::vector<int> & {
+                for (unsigned int i=0;i<freeDimensions.size();i++) expandedPoint[freeDimensions[i]] = point[i];
+                return expandedPoint;
+            };
+            KnownResults projectedKnownResults;
+            if (knownResults!=nullptr) {
+                for (auto const &point : knownResults->feasiblePoints) {
+                    projectedKnownResults.feasiblePoints.push_back(std::vector<int>());
+                    for (unsigned int i : freeDimensions) projectedKnownResults.feasiblePoints.back().push_back(point[i]);
+                }
+                for (auto const &point : knownResults->infeasiblePoints) {
+                    projectedKnownResults.infeasiblePoints.push_back(std::vector<int>());
+                    for (unsigned int i : freeDimensions) projectedKnownResults.infeasiblePoints.back().push_back(point[i]);
+                }
+                knownResults->feasiblePoints.clear();
+                knownResults->infeasiblePoints.clear();
+            }
+
+            // Cores reported by "fn" are translated to the projected dimensions. Projected away dimensions cannot
+            // be raised anyway.
+            std::vector<int> projectedDimensions(limits.size(),-1);
+            for (unsigned int i=0;i<freeDimensions.size();i++) projectedDimensions[freeDimensions[i]] = i;
+            std::vector<unsigned int> expandedCore;
+            FeasibilityFunctionWithCore projectedFn = [&fn,&expand,&projectedDimensions,&expandedCore](const std::vector<int> &point, std::vector<unsigned int> &core) {
+                expandedCore.resize(projectedDimensions.size());
+                for (unsigned int i=0;i<projectedDimensions.size();i++) expandedCore[i] = i;
+                bool result = fn(expand(point),expandedCore);
+                if (!result) {
+                    core.clear();
+                    for (unsigned int i : expandedCore) {
+                        if (projectedDimensions[i]>=0) core.push_back(projectedDimensions[i]);
+                    }
+                }
+                return result;
+            };
+            enumerateParetoFront([&callBack,&expand](const std::vector<int> &point) { callBack(expand(point)); },
+                projectedFn,projectedLimits,strategy,statistics,(knownResults==nullptr)?nullptr:&projectedKnownResults,memoryBudget);
+            if (knownResults!=nullptr) {
+                for (auto const &point : projectedKnownResults.feasiblePoints) knownResults->feasiblePoints.push_back(expand(point));
+                for (auto const &point : projectedKnownResults.infeasiblePoints) knownResults->infeasiblePoints.push_back(expand(point));
+            }
+            return;
+        }
 
         // Buffer the number of dimensions of the search space
         unsigned const int nofDimensions = limits.size();
 
-        // Reserve the sets "P" and "S" from the paper
-        std::list<std::vector<int> > paretoFront;
-        std::list<std::vector<int> > coParetoElements;
+        // Reserve the set "S" from the paper. The points in it are stored in encoded form, and the points before
+        // "firstCoParetoElement" have already been removed from the set.
+        PointEncoding encoding(limits);
+        FlatPointList coParetoElements(encoding);
+        size_t firstCoParetoElement = 0;
+        std::vector<uint64_t> encodedPoint;
 
-        // Negative result buffer
-        NegativeResultBuffer negativeResultBuffer;
+        // Memo table and negative/positive result buffers
+        EnumerationStatistics localStatistics;
+        CachedFeasibilityFunction cachedFn(fn,limits,(statistics==nullptr)?localStatistics:*statistics,memoryBudget);
+        GroupTestingMinimizer groupTestingMinimizer;
+        if (knownResults!=nullptr) {
+            for (auto const &point : knownResults->feasiblePoints) cachedFn.addKnownResult(point,true);
+            for (auto const &point : knownResults->infeasiblePoints) cachedFn.addKnownResult(point,false);
+            knownResults->feasiblePoints.clear();
+            knownResults->infeasiblePoints.clear();
+        }
+
+        // Memory accounting for the co-Pareto set. The caches are shrunk if the budget is exceeded.
+        auto reportCoParetoSet = [memoryBudget,&cachedFn,&coParetoElements]() {
+            if (memoryBudget==nullptr) return;
+            memoryBudget->setFootprint(CO_PARETO_SET,coParetoElements.getFootprint());
+            cachedFn.enforceMemoryBudget();
+        };
 
         // Add the maximal element to the coParetoElements
         {
             std::vector<int> maximalElement;
-            for (auto const i : limits) {
+            for (auto const &i : limits) {
                 maximalElement.push_back(i.second);
             }
-            coParetoElements.push_back(maximalElement);
+            encoding.encode(maximalElement,encodedPoint);
+            coParetoElements.add(encodedPoint.data());
         }
 
         // Main loop
-        while (!coParetoElements.empty()) {
-            std::vector<int> &testPoint = coParetoElements.front();
-            if (!(negativeResultBuffer.isContained(testPoint))) {
-                if (fn(testPoint)) {
-                    // A Pareto point is missing. Let us find where exactly it is.
-                    // We need to work on a copy of the point in order not to spoil
-                    // the point form the coParetoElements
-                    std::vector<int> x = testPoint;
-                    for (unsigned int i=0;i<nofDimensions;i++) {
-                        int max = x[i]+1;
-                        int min = limits[i].first;
-                        while ((max - min)>1) {
-                            int mid = min + ((max-min-1)/2);
-                            x[i] = mid;
-                            if (negativeResultBuffer.isContained(x)) {
-                                min = mid+1;
-                            } else {
-                                if (fn(x)) {
-                                    max = mid+1;
-                                } else {
-                                    min = mid+1;
-                                    negativeResultBuffer.addPoint(x);
-                                }
-                            }
-                        }
-                        x[i] = min;
-                    }
-                    callBack(x);
+        std::vector<uint64_t> modifiedPoint;
+        while (firstCoParetoElement<coParetoElements.size()) {
+            reportCoParetoSet();
+            std::vector<int> testPoint = coParetoElements.getPoint(firstCoParetoElement);
+            if (cachedFn(testPoint)) {
+                // A Pareto point is missing. Let us find where exactly it is.
+                // We need to work on a copy of the point in order not to spoil
+                // the point form the coParetoElements
+                std::vector<int> x = testPoint;
+                if (strategy==GROUPTESTING) {
+                    groupTestingMinimizer.minimize(x,limits,cachedFn);
+                } else {
+                    minimizeDimensionwise(x,limits,cachedFn);
+                }
+                callBack(x);
 
-                    // Now update all points in the coParetoFront
-                    std::list<std::vector<int> > coParetoElementsMod;
-                    for (auto const &y : coParetoElements) {
-                        if (!vectorOfIntIsLeq(x,y)) {
-                            coParetoElementsMod.push_back(y);
-                        } else {
-                            for (unsigned int i=0;i<nofDimensions;i++) {
-                                if (x[i]>limits[i].first) {
-                                    coParetoElementsMod.push_back(y);
-                                    std::vector<int> &mod = coParetoElementsMod.back();
-                                    mod[i] = x[i]-1;
-                                }
+                // Now update all points in the coParetoFront
+                encoding.encode(x,encodedPoint);
+                FlatPointList coParetoElementsMod(encoding);
+                for (size_t j=firstCoParetoElement;j<coParetoElements.size();j++) {
+                    const uint64_t *y = coParetoElements.getData(j);
+                    if (!encoding.isLeq(encodedPoint.data(),y)) {
+                        coParetoElementsMod.add(y);
+                    } else {
+                        for (unsigned int i=0;i<nofDimensions;i++) {
+                            if (x[i]>limits[i].first) {
+                                modifiedPoint.assign(y,y+encoding.getNofWords());
+                                encoding.setValue(modifiedPoint.data(),i,x[i]-1);
+                                coParetoElementsMod.add(modifiedPoint.data());
                             }
                         }
                     }
-                    coParetoElements = cleanParetoFront(coParetoElementsMod);
-
-                } else {
-                    // Get rid of this point in the co-Pareto front and add to the negative results buffer
-                    negativeResultBuffer.addPoint(testPoint);
-                    coParetoElements.pop_front();
                 }
+                FlatPointList cleanedCoParetoElements(encoding);
+                cleanCoParetoSet(coParetoElementsMod,cleanedCoParetoElements,encoding);
+                coParetoElements.swap(cleanedCoParetoElements);
+                firstCoParetoElement = 0;
+
             } else {
-                // Get rid of this point in the co-Pareto front
-                coParetoElements.pop_front();
+                // Get rid of this point in the co-Pareto front. The cached function has already
+                // added it to the negative results buffer. The removed points are only dropped from
+                // memory once they make up half of the list, so that this takes amortized constant time.
+                firstCoParetoElement++;
+                if (2*firstCoParetoElement>=coParetoElements.size()) {
+                    coParetoElements.removeFirst(firstCoParetoElement);
+                    firstCoParetoElement = 0;
+                }
             }
         }
+
+        if (knownResults!=nullptr) cachedFn.getKnownResults(*knownResults);
+        if (memoryBudget!=nullptr) {
+            for (MemoryBudgetItem item : {CO_PARETO_SET,MEMO_TABLE,NEGATIVE_RESULT_BUFFER,POSITIVE_RESULT_BUFFER}) memoryBudget->setFootprint(item,0);
+        }
     }
 
 } // End of namespace
@@ -41,11 +41,68 @@
 #include <list>
 #include <vector>
 #include <functional>
+#include <ostream>
+#include <cstddef>
 
 namespace paretoenumerator {
 
+    // Counters for the calls to the feasibility function and the caches in front of it
+    class EnumerationStatistics {
+    public:
+        unsigned long nofOracleCalls = 0;
+        unsigned long nofMemoHits = 0;
+        unsigned long nofNegativeBufferHits = 0;
+        unsigned long nofPositiveBufferHits = 0;
+        unsigned long nofKnownResultsUsed = 0;
+        unsigned long nofGeneralizedNegativeResults = 0;
+        void print(std::ostream &os) const;
+    };
+
+    // The data structures of the enumeration and of the caller whose memory is accounted for
+    typedef enum { EXAMPLES, PREFIX_TRIE, PAST_CHAINS, KNOWN_RESULTS, CO_PARETO_SET, MEMO_TABLE, NEGATIVE_RESULT_BUFFER, POSITIVE_RESULT_BUFFER, NOF_MEMORY_BUDGET_ITEMS } MemoryBudgetItem;
+
+    // Accounting of the memory used by the data structures of the enumeration and of the caller. If the sum of
+    // the footprints exceeds the limit, the enumeration shrinks its caches. If this does not suffice, it throws
+    // an error message (as an std::string). Without a limit, only the peak footprints are tracked.
+    class MemoryBudget {
+        size_t footprints[NOF_MEMORY_BUDGET_ITEMS] = {};
+        size_t peakFootprints[NOF_MEMORY_BUDGET_ITEMS] = {};
+        bool used[NOF_MEMORY_BUDGET_ITEMS] = {};
+    public:
+        size_t limit = 0; // In bytes. 0 means no limit.
+        unsigned long nofCacheShrinks = 0;
+        inline void setFootprint(MemoryBudgetItem item, size_t bytes) {
+            footprints[item] = bytes;
+            if (bytes>peakFootprints[item]) peakFootprints[item] = bytes;
+            used[item] = true;
+        }
+        size_t getTotalFootprint() const;
+        bool isExceeded() const { return (limit>0) && (getTotalFootprint()>limit); }
+        void print(std::ostream &os, bool peak) const;
+    };
+
+    // How a feasible point is lowered to a Pareto point. Both strategies yield the same point. The group
+    // testing strategy lowers blocks of dimensions with a range of size one together.
+    typedef enum { DIMENSIONWISE, GROUPTESTING } MinimizationStrategy;
+
+    // Points for which the value of the feasibility function is known. They can be given to the enumeration
+    // in order to save calls to the feasibility function, and are replaced by the (minimal feasible and maximal
+    // infeasible) points with known values after the enumeration. Points outside of the limits are moved into
+    // the search space where this does not change the value of the feasibility function, and dropped otherwise.
+    class KnownResults {
+    public:
+        std::list<std::vector<int> > feasiblePoints;
+        std::list<std::vector<int> > infeasiblePoints;
+    };
+
+    // A feasibility function that can explain negative results. When called, the second parameter contains all
+    // dimensions. If the function returns false, it may reduce them to a core of dimensions such that all points
+    // that are at most as large as the given point in the core dimensions are infeasible as well.
+    typedef std::function<bool(const std::vector<int> &, std::vector<unsigned int> &)> FeasibilityFunctionWithCore;
+
     // Main function
-    void enumerateParetoFront(std::function<void(const std::vector<int> &)> callBack, std::function<bool(const std::vector<int> &)> fn, const std::vector<std::pair<int,int> > &limits);
+    void enumerateParetoFront(std::function<void(const std::vector<int> &)> callBack, std::function<bool(const std::vector<int> &)> fn, const std::vector<std::pair<int,int> > &limits, MinimizationStrategy strategy = DIMENSIONWISE, EnumerationStatistics *statistics = nullptr, KnownResults *knownResults = nullptr, MemoryBudget *memoryBudget = nullptr);
+    void enumerateParetoFront(std::function<void(const std::vector<int> &)> callBack, FeasibilityFunctionWithCore fn, const std::vector<std::pair<int,int> > &limits, MinimizationStrategy strategy = DIMENSIONWISE, EnumerationStatistics *statistics = nullptr, KnownResults *knownResults = nullptr, MemoryBudget *memoryBudget = nullptr);
 
     // Additional functions that will remain stable and may be useful for some applications
     std::list<std::vector<int> > cleanParetoFront(const std::list<std::vector<int> > &input);
@@ -1 +1 @@
-g++ -O2 -g -std=c++14 -Wall -W -fPIC -DNDEBUG -I. main.cpp pareto_enumerator.cpp -static -o solver
+g++ -O2 -g -std=c++14 -Wall -W -fPIC -DNDEBUG -I. main.cpp learner.cpp pareto_enumerator.cpp -static -o solver
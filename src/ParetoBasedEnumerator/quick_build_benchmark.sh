@@ -0,0 +1 @@
+g++ -O2 -g -std=c++14 -Wall -W -fPIC -DNDEBUG -I. benchmark.cpp learner.cpp pareto_enumerator.cpp -static -o benchmark
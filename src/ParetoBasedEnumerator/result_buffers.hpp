@@ -0,0 +1,244 @@
+#ifndef RESULT_BUFFERS_HPP__
+#define RESULT_BUFFERS_HPP__
+
+/*
+ * This is
+ *   result_buffers.hpp
+ * that contains the buffers for the results of the feasibility function used by the
+ * Pareto front enumeration in pareto_enumerator.cpp. It is a separate header so that
+ * the buffers can be benchmarked on their own.
+ */
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace paretoenumerator {
+
+    /**
+     * @brief Compact representation of search space points as sequences of 64-bit words. If all dimensions
+     * only have the values 0 and 1, a point is stored as a bit vector. Otherwise, every value is stored
+     * in a word of its own.
+     */
+    class PointEncoding {
+        size_t nofDimensions;
+        bool binary;
+    public:
+        PointEncoding(const std::vector<std::pair<int,int> > &limits) : nofDimensions(limits.size()), binary(true) {
+            for (auto const &limit : limits) binary &= (limit.first>=0) && (limit.second<=1);
+        }
+        size_t getNofWords() const {
+            return binary?((nofDimensions+63)/64):nofDimensions;
+        }
+
+        void encode(const std::vector<int> &point, std::vector<uint64_t> &words) const {
+            if (binary) {
+                words.assign(getNofWords(),0);
+                for (size_t i=0;i<nofDimensions;i++) {
+                    if (point[i]) words[i/64] |= ((uint64_t)1) << (i % 64);
+                }
+            } else {
+                words.resize(nofDimensions);
+                for (size_t i=0;i<nofDimensions;i++) words[i] = (uint64_t)(int64_t)point[i];
+            }
+        }
+
+        std::vector<int> decode(const uint64_t *words) const {
+            std::vector<int> point(nofDimensions);
+            for (size_t i=0;i<nofDimensions;i++) {
+                if (binary) {
+                    point[i] = (words[i/64] >> (i % 64)) & 1;
+                } else {
+                    point[i] = (int)(int64_t)words[i];
+                }
+            }
+            return point;
+        }
+
+        int getValue(const uint64_t *words, size_t i) const {
+            return binary?(int)((words[i/64] >> (i % 64)) & 1):(int)(int64_t)words[i];
+        }
+        void setValue(uint64_t *words, size_t i, int value) const {
+            if (binary) {
+                if (value) {
+                    words[i/64] |= ((uint64_t)1) << (i % 64);
+                } else {
+                    words[i/64] &= ~(((uint64_t)1) << (i % 64));
+                }
+            } else {
+                words[i] = (uint64_t)(int64_t)value;
+            }
+        }
+
+        // Is the point "a" at most as large as the point "b" in every dimension?
+        bool isLeq(const uint64_t *a, const uint64_t *b) const {
+            if (binary) {
+                for (size_t i=0;i<(nofDimensions+63)/64;i++) {
+                    if (a[i] & ~b[i]) return false;
+                }
+            } else {
+                for (size_t i=0;i<nofDimensions;i++) {
+                    if ((int64_t)b[i]<(int64_t)a[i]) return false;
+                }
+            }
+            return true;
+        }
+
+        bool isEqual(const uint64_t *a, const uint64_t *b) const {
+            return std::equal(a,a+getNofWords(),b);
+        }
+    };
+
+
+    /**
+     * @brief A list of encoded search space points that is stored in one consecutive block of memory, as
+     * the result buffers are scanned completely in every query.
+     */
+    class FlatPointList {
+        const PointEncoding &encoding;
+        size_t nofWords;
+        size_t nofPoints; // Separate from the size of "points" as points in a zero-dimensional space have no words
+        std::vector<uint64_t> points;
+    public:
+        FlatPointList(const PointEncoding &_encoding) : encoding(_encoding), nofWords(_encoding.getNofWords()), nofPoints(0) {}
+
+        // Is some point in the list at least as large as "data"?
+        bool hasLargerOrEqualPoint(const uint64_t *data) const {
+            for (size_t i=0;i<nofPoints;i++) {
+                if (encoding.isLeq(data,getData(i))) return true;
+            }
+            return false;
+        }
+
+        // Is some point in the list at most as large as "data"?
+        bool hasSmallerOrEqualPoint(const uint64_t *data) const {
+            for (size_t i=0;i<nofPoints;i++) {
+                if (encoding.isLeq(getData(i),data)) return true;
+            }
+            return false;
+        }
+
+        // Removes all points that are at most (or at least, if "smaller" is false) as large as "data".
+        // The order of the remaining points is not preserved.
+        void removePointsDominatedBy(const uint64_t *data, bool smaller) {
+            size_t i = 0;
+            while (i<nofPoints) {
+                bool dominated = smaller?encoding.isLeq(getData(i),data):encoding.isLeq(data,getData(i));
+                if (dominated) {
+                    nofPoints--;
+                    if (i!=nofPoints) std::copy(points.begin()+nofPoints*nofWords,points.end(),points.begin()+i*nofWords);
+                    points.resize(nofPoints*nofWords);
+                } else {
+                    i++;
+                }
+            }
+        }
+
+        void add(const uint64_t *data) {
+            points.insert(points.end(),data,data+nofWords);
+            nofPoints++;
+        }
+
+        // Keeps only the first "nofPointsToKeep" points
+        void truncate(size_t nofPointsToKeep) {
+            if (nofPointsToKeep<nofPoints) {
+                points.resize(nofPointsToKeep*nofWords);
+                points.shrink_to_fit();
+                nofPoints = nofPointsToKeep;
+            }
+        }
+
+        // Removes the first "nofPointsToRemove" points, keeping the order of the remaining ones
+        void removeFirst(size_t nofPointsToRemove) {
+            points.erase(points.begin(),points.begin()+nofPointsToRemove*nofWords);
+            nofPoints -= nofPointsToRemove;
+        }
+
+        void swap(FlatPointList &other) {
+            points.swap(other.points);
+            std::swap(nofPoints,other.nofPoints);
+        }
+
+        size_t size() const { return nofPoints; }
+        const uint64_t *getData(size_t i) const { return points.data()+i*nofWords; }
+        std::vector<int> getPoint(size_t i) const {
+            return encoding.decode(getData(i));
+        }
+        size_t getFootprint() const { return sizeof(FlatPointList)+points.capacity()*sizeof(uint64_t); }
+    };
+
+
+    /**
+     * @brief A class that buffers negative results from the feasibility function so that no
+     * redundant calls are made to it.
+     *
+     * Dominated points are removed from the buffer
+     */
+    class NegativeResultBuffer {
+        const PointEncoding &encoding;
+        FlatPointList oldValueBuffer;
+        std::vector<uint64_t> encoded;
+    public:
+        NegativeResultBuffer(const PointEncoding &_encoding) : encoding(_encoding), oldValueBuffer(_encoding) {}
+
+        bool isContained(const uint64_t *data) const {
+            return oldValueBuffer.hasLargerOrEqualPoint(data);
+        }
+        bool isContained(const std::vector<int> &data) {
+            encoding.encode(data,encoded);
+            return isContained(encoded.data());
+        }
+
+        void addPoint(const uint64_t *data) {
+            oldValueBuffer.removePointsDominatedBy(data,true);
+            oldValueBuffer.add(data);
+        }
+        void addPoint(const std::vector<int> &data) {
+            encoding.encode(data,encoded);
+            addPoint(encoded.data());
+        }
+
+        const FlatPointList &getPoints() const { return oldValueBuffer; }
+        FlatPointList &getPoints() { return oldValueBuffer; }
+    };
+
+
+    /**
+     * @brief The counterpart of the NegativeResultBuffer for positive results. As the feasibility
+     * function is monotone, every point that is at least as large as a point for which the
+     * feasibility function returned true is feasible as well.
+     *
+     * Only the minimal points are kept in the buffer.
+     */
+    class PositiveResultBuffer {
+        const PointEncoding &encoding;
+        FlatPointList oldValueBuffer;
+        std::vector<uint64_t> encoded;
+    public:
+        PositiveResultBuffer(const PointEncoding &_encoding) : encoding(_encoding), oldValueBuffer(_encoding) {}
+
+        bool isContained(const uint64_t *data) const {
+            return oldValueBuffer.hasSmallerOrEqualPoint(data);
+        }
+        bool isContained(const std::vector<int> &data) {
+            encoding.encode(data,encoded);
+            return isContained(encoded.data());
+        }
+
+        void addPoint(const uint64_t *data) {
+            oldValueBuffer.removePointsDominatedBy(data,false);
+            oldValueBuffer.add(data);
+        }
+        void addPoint(const std::vector<int> &data) {
+            encoding.encode(data,encoded);
+            addPoint(encoded.data());
+        }
+
+        const FlatPointList &getPoints() const { return oldValueBuffer; }
+        FlatPointList &getPoints() { return oldValueBuffer; }
+    };
+
+} // End of namespace
+
+#endif